@@ -77,6 +77,7 @@ m_mqttAuthEnabled(false),
 m_mqttUsername(),
 m_mqttPassword(),
 m_ysfNetHosts(),
+m_ysfNetSharedPort(0U),
 m_ysfRFHangTime(60U),
 m_ysfNetHangTime(60U),
 m_ysfNetDebug(false),
@@ -247,6 +248,8 @@ bool CConf::read()
 		} else if (section == SECTION::YSF_NETWORK) {
 			if (::strcmp(key, "Hosts") == 0)
 				m_ysfNetHosts = value;
+			else if (::strcmp(key, "SharedPort") == 0)
+				m_ysfNetSharedPort = (unsigned short)::atoi(value);
 			else if (::strcmp(key, "RFHangTime") == 0)
 				m_ysfRFHangTime = (unsigned int)::atoi(value);
 			else if (::strcmp(key, "NetHangTime") == 0)
@@ -484,6 +487,11 @@ std::string CConf::getYSFNetHosts() const
 	return m_ysfNetHosts;
 }
 
+unsigned short CConf::getYSFNetSharedPort() const
+{
+	return m_ysfNetSharedPort;
+}
+
 std::vector<DGIdData*> CConf::getDGIdData() const
 {
 	return m_dgIdData;
@@ -93,6 +93,7 @@ public:
 
 	// The YSF Network section
 	std::string  getYSFNetHosts() const;
+	unsigned short getYSFNetSharedPort() const;
 
 	// The DG-ID Section
 	std::vector<DGIdData*> getDGIdData() const;
@@ -142,6 +143,7 @@ private:
 	std::string  m_mqttPassword;
 
 	std::string  m_ysfNetHosts;
+	unsigned short m_ysfNetSharedPort;
 	unsigned int m_ysfRFHangTime;
 	unsigned int m_ysfNetHangTime;
 	bool         m_ysfNetDebug;
@@ -19,13 +19,17 @@
 #include "MQTTConnection.h"
 #include "YSFReflectors.h"
 #include "DGIdGateway.h"
+#include "DNSResolver.h"
 #include "DGIdNetwork.h"
 #include "IMRSNetwork.h"
+#include "YSFSharedSocket.h"
 #include "YSFNetwork.h"
 #include "FCSNetwork.h"
 #include "UDPSocket.h"
 #include "StopWatch.h"
+#include "EventLoop.h"
 #include "Version.h"
+#include "YSFFrameView.h"
 #include "YSFFICH.h"
 #include "Thread.h"
 #include "Timer.h"
@@ -71,8 +75,21 @@ static void sigHandler(int signum)
 
 const unsigned int UNSET_DGID = 999U;
 
+// Start-up lookups run side by side on these threads, answers are kept for an hour
+const unsigned int DNS_THREADS   = 4U;
+const unsigned int DNS_CACHE_TTL = 3600U;
+
 const unsigned char WIRESX_DGID = 127U;
 
+// The longest wait for a socket, so that the timers still run when idle
+const unsigned int EVENT_LOOP_TICK = 5U;
+
+// A network in use, and the number of its socket in the event loop
+struct CActiveNetwork {
+	CDGIdNetwork* m_network;
+	unsigned int  m_socket;
+};
+
 const unsigned char DT_VD_MODE1      = 0x01U;
 const unsigned char DT_VD_MODE2      = 0x02U;
 const unsigned char DT_VOICE_FR_MODE = 0x04U;
@@ -256,10 +273,42 @@ int CDGIdGateway::run()
 
 	rptNetwork.link();
 
+	CDNSResolver* resolver = new CDNSResolver(DNS_THREADS, DNS_CACHE_TTL);
+	ret = resolver->start();
+	if (!ret)
+		return 1;
+
+	// Queue every DG-ID address now so that they resolve alongside the reflectors
+	std::vector<DGIdData*> dgIdData = m_conf.getDGIdData();
+	for (const auto& it1 : dgIdData) {
+		if (it1->m_type == "FCS") {
+			char url[50U];
+			::sprintf(url, "%.6s.xreflector.net", it1->m_name.c_str());
+			resolver->prefetch(url, FCS_PORT);
+		} else if (it1->m_type == "IMRS") {
+			for (const auto& it2 : it1->m_destinations)
+				resolver->prefetch(it2->m_address, IMRS_PORT);
+		} else if (it1->m_type != "YSF") {
+			resolver->prefetch(it1->m_address, it1->m_port);
+		}
+	}
+
 	std::string fileName = m_conf.getYSFNetHosts();
-	CYSFReflectors* reflectors = new CYSFReflectors(fileName);
+	CYSFReflectors* reflectors = new CYSFReflectors(fileName, *resolver);
 	reflectors->load();
 
+	// All of the YSF type back-ends may use the one local port
+	CYSFSharedSocket* shared = nullptr;
+	unsigned short sharedPort = m_conf.getYSFNetSharedPort();
+	if (sharedPort > 0U) {
+		shared = new CYSFSharedSocket(sharedPort);
+		ret = shared->open();
+		if (!ret) {
+			delete shared;
+			shared = nullptr;
+		}
+	}
+
 	CIMRSNetwork* imrs = new CIMRSNetwork;
 	ret = imrs->open();
 	if (!ret) {
@@ -274,7 +323,6 @@ int CDGIdGateway::run()
 	for (unsigned int i = 0U; i < 100U; i++)
 		dgIdNetwork[i] = nullptr; 
 
-	std::vector<DGIdData*> dgIdData = m_conf.getDGIdData();
 	for (const auto& it1 : dgIdData) {
 		unsigned int dgid        = it1->m_dgId;
 		if (dgid >= 100U)
@@ -294,7 +342,7 @@ int CDGIdGateway::run()
 			std::string locator      = calculateLocator();
 			unsigned int id          = m_conf.getId();
 
-			dgIdNetwork[dgid] = new CFCSNetwork(name, local, m_callsign, rxFrequency, txFrequency, locator, id, statc, debug);
+			dgIdNetwork[dgid] = new CFCSNetwork(name, local, m_callsign, rxFrequency, txFrequency, locator, id, *resolver, statc, debug);
 			dgIdNetwork[dgid]->m_modes       = DT_VD_MODE1 | DT_VD_MODE2 | DT_VOICE_FR_MODE | DT_DATA_FR_MODE;
 			dgIdNetwork[dgid]->m_static      = statc;
 			dgIdNetwork[dgid]->m_rfHangTime  = rfHangTime;
@@ -308,7 +356,7 @@ int CDGIdGateway::run()
 
 			CYSFReflector* reflector = reflectors->findByName(name);
 			if (reflector != nullptr) {
-				dgIdNetwork[dgid] = new CYSFNetwork(local, *reflector, m_callsign, statc, debug);
+				dgIdNetwork[dgid] = new CYSFNetwork(local, *reflector, m_callsign, shared, statc, debug);
 				dgIdNetwork[dgid]->m_modes       = DT_VD_MODE1 | DT_VD_MODE2 | DT_VOICE_FR_MODE | DT_DATA_FR_MODE;
 				dgIdNetwork[dgid]->m_static      = statc;
 				dgIdNetwork[dgid]->m_rfHangTime  = rfHangTime;
@@ -328,7 +376,7 @@ int CDGIdGateway::run()
 				for (const auto& it2 : destinations) {
 					sockaddr_storage addr;
 					unsigned int addrLen;
-					if (CUDPSocket::lookup(it2->m_address, IMRS_PORT, addr, addrLen) == 0) {
+					if (resolver->lookup(it2->m_address, IMRS_PORT, addr, addrLen)) {
 						IMRSDest* dest = new IMRSDest;
 						dest->m_dgId    = it2->m_dgId;
 						dest->m_addr    = addr;
@@ -355,8 +403,8 @@ int CDGIdGateway::run()
 
 			sockaddr_storage addr;
 			unsigned int     addrLen;
-			if (CUDPSocket::lookup(it1->m_address, it1->m_port, addr, addrLen) == 0) {
-				dgIdNetwork[dgid] = new CYSFNetwork(local, "YSFGateway", addr, addrLen, m_callsign, statc, debug);
+			if (resolver->lookup(it1->m_address, it1->m_port, addr, addrLen)) {
+				dgIdNetwork[dgid] = new CYSFNetwork(local, "YSFGateway", addr, addrLen, m_callsign, shared, statc, debug);
 				dgIdNetwork[dgid]->m_modes       = DT_VD_MODE1 | DT_VD_MODE2 | DT_VOICE_FR_MODE | DT_DATA_FR_MODE;
 				dgIdNetwork[dgid]->m_static      = statc;
 				dgIdNetwork[dgid]->m_rfHangTime  = rfHangTime;
@@ -372,8 +420,8 @@ int CDGIdGateway::run()
 
 			sockaddr_storage addr;
 			unsigned int     addrLen;
-			if (CUDPSocket::lookup(it1->m_address, it1->m_port, addr, addrLen) == 0) {
-				dgIdNetwork[dgid] = new CYSFNetwork(local, "PARROT", addr, addrLen, m_callsign, statc, debug);
+			if (resolver->lookup(it1->m_address, it1->m_port, addr, addrLen)) {
+				dgIdNetwork[dgid] = new CYSFNetwork(local, "PARROT", addr, addrLen, m_callsign, shared, statc, debug);
 				dgIdNetwork[dgid]->m_modes       = DT_VD_MODE1 | DT_VD_MODE2 | DT_VOICE_FR_MODE | DT_DATA_FR_MODE;
 				dgIdNetwork[dgid]->m_static      = statc;
 				dgIdNetwork[dgid]->m_rfHangTime  = rfHangTime;
@@ -389,8 +437,8 @@ int CDGIdGateway::run()
 
 			sockaddr_storage addr;
 			unsigned int     addrLen;
-			if (CUDPSocket::lookup(it1->m_address, it1->m_port, addr, addrLen) == 0) {
-				dgIdNetwork[dgid] = new CYSFNetwork(local, "YSF2DMR", addr, addrLen, m_callsign, statc, debug);
+			if (resolver->lookup(it1->m_address, it1->m_port, addr, addrLen)) {
+				dgIdNetwork[dgid] = new CYSFNetwork(local, "YSF2DMR", addr, addrLen, m_callsign, shared, statc, debug);
 				dgIdNetwork[dgid]->m_modes       = DT_VD_MODE1 | DT_VD_MODE2;
 				dgIdNetwork[dgid]->m_static      = statc;
 				dgIdNetwork[dgid]->m_rfHangTime  = rfHangTime;
@@ -406,8 +454,8 @@ int CDGIdGateway::run()
 
 			sockaddr_storage addr;
 			unsigned int     addrLen;
-			if (CUDPSocket::lookup(it1->m_address, it1->m_port, addr, addrLen) == 0) {
-				dgIdNetwork[dgid] = new CYSFNetwork(local, "YSF2NXDN", addr, addrLen, m_callsign, statc, debug);
+			if (resolver->lookup(it1->m_address, it1->m_port, addr, addrLen)) {
+				dgIdNetwork[dgid] = new CYSFNetwork(local, "YSF2NXDN", addr, addrLen, m_callsign, shared, statc, debug);
 				dgIdNetwork[dgid]->m_modes       = DT_VD_MODE1 | DT_VD_MODE2;
 				dgIdNetwork[dgid]->m_static      = statc;
 				dgIdNetwork[dgid]->m_rfHangTime  = rfHangTime;
@@ -423,8 +471,8 @@ int CDGIdGateway::run()
 
 			sockaddr_storage addr;
 			unsigned int     addrLen;
-			if (CUDPSocket::lookup(it1->m_address, it1->m_port, addr, addrLen) == 0) {
-				dgIdNetwork[dgid] = new CYSFNetwork(local, "YSF2P25", addr, addrLen, m_callsign, statc, debug);
+			if (resolver->lookup(it1->m_address, it1->m_port, addr, addrLen)) {
+				dgIdNetwork[dgid] = new CYSFNetwork(local, "YSF2P25", addr, addrLen, m_callsign, shared, statc, debug);
 				dgIdNetwork[dgid]->m_modes       = DT_VOICE_FR_MODE;
 				dgIdNetwork[dgid]->m_static      = statc;
 				dgIdNetwork[dgid]->m_rfHangTime  = rfHangTime;
@@ -454,6 +502,37 @@ int CDGIdGateway::run()
 
 	createGPS();
 
+	// Only the DG-IDs that are in use are visited on each pass, and the IMRS
+	// network, which serves several of them, is only clocked and read once
+	CEventLoop eventLoop(EVENT_LOOP_TICK);
+	unsigned int rptSocket = eventLoop.addSocket(rptNetwork.getSocket());
+
+	unsigned int sharedSocket = 0U;
+	if (shared != nullptr)
+		sharedSocket = eventLoop.addSocket(shared->getSocket());
+
+	std::vector<unsigned int> activeDGIds;
+	std::vector<CActiveNetwork> activeNetworks;
+	for (unsigned int i = 0U; i < 100U; i++) {
+		if (dgIdNetwork[i] == nullptr)
+			continue;
+
+		activeDGIds.push_back(i);
+
+		bool found = false;
+		for (const auto& it : activeNetworks) {
+			if (it.m_network == dgIdNetwork[i])
+				found = true;
+		}
+
+		if (!found) {
+			CActiveNetwork network;
+			network.m_network = dgIdNetwork[i];
+			network.m_socket  = eventLoop.addSocket(dgIdNetwork[i]->getSocket());
+			activeNetworks.push_back(network);
+		}
+	}
+
 	CTimer inactivityTimer(1000U);
 	CTimer bleepTimer(1000U, 1U);
 
@@ -471,13 +550,28 @@ int CDGIdGateway::run()
 	writeJSONUnlinked("startup");
 
 	while (!m_killed) {
+		eventLoop.wait();
+
+		if (eventLoop.isReadable(rptSocket))
+			rptNetwork.readSocket();
+
+		if (shared != nullptr && eventLoop.isReadable(sharedSocket))
+			shared->readSocket();
+
+		for (const auto& it : activeNetworks) {
+			if (eventLoop.isReadable(it.m_socket))
+				it.m_network->readSocket();
+		}
+
 		unsigned char buffer[200U];
 		memset(buffer, 0U, 200U);
 
 		if (rptNetwork.read(0U, buffer) > 0U) {
-			CYSFFICH fich;
-			bool valid = fich.decode(buffer + 35U);
+			CYSFFrameView frame(buffer);
+			bool valid = frame.decodeFICH();
 			if (valid) {
+				CYSFFICH fich = frame.getFICH();
+
 				unsigned char dgId = fich.getDGId();
 
 				if (dgId == WIRESX_DGID)
@@ -507,7 +601,7 @@ int CDGIdGateway::run()
 				}
 
 				if (m_gps != nullptr)
-					m_gps->data(buffer + 14U, buffer + 35U, fich);
+					m_gps->data(frame);
 
 				if (currentDGId != UNSET_DGID && dgIdNetwork[currentDGId] != nullptr) {
 					// Only allow the wanted modes through
@@ -519,8 +613,7 @@ int CDGIdGateway::run()
 						unsigned char origDGId = fich.getDGId();
 						if (origDGId != WIRESX_DGID) {
 							unsigned int newDGId = dgIdNetwork[currentDGId]->getDGId();
-							fich.setDGId(newDGId);
-							fich.encode(buffer + 35U);
+							fich.setDGId(newDGId, buffer + 35U);
 						}
 
 						dgIdNetwork[currentDGId]->write(currentDGId, buffer);
@@ -539,33 +632,30 @@ int CDGIdGateway::run()
 			}
 		}
 
-		for (unsigned int i = 0U; i < 100U; i++) {
-			if (dgIdNetwork[i] != nullptr) {
-				unsigned int len = dgIdNetwork[i]->read(i, buffer);
-				if (len > 0U && (i == currentDGId || currentDGId == UNSET_DGID)) {
-					CYSFFICH fich;
-					bool valid = fich.decode(buffer + 35U);
-					if (valid) {
-						unsigned char dgId = fich.getDGId();
-						if (dgId != WIRESX_DGID) {
-							fich.setDGId(i);
-							fich.encode(buffer + 35U);
-						}
+		for (unsigned int i : activeDGIds) {
+			unsigned int len = dgIdNetwork[i]->read(i, buffer);
+			if (len > 0U && (i == currentDGId || currentDGId == UNSET_DGID)) {
+				CYSFFICH fich;
+				bool valid = fich.decode(buffer + 35U);
+				if (valid) {
+					unsigned char dgId = fich.getDGId();
+					if (dgId != WIRESX_DGID) {
+						fich.setDGId(i, buffer + 35U);
+					}
 
-						rptNetwork.write(0U, buffer);
+					rptNetwork.write(0U, buffer);
 
-						inactivityTimer.setTimeout(dgIdNetwork[i]->m_netHangTime);
-						inactivityTimer.start();
+					inactivityTimer.setTimeout(dgIdNetwork[i]->m_netHangTime);
+					inactivityTimer.start();
 
-						if (currentDGId == UNSET_DGID) {
-							std::string desc  = dgIdNetwork[i]->getDesc(i);
-							std::string proto = dgIdNetwork[i]->m_protocol;
-							LogMessage("DG-ID set to %u (%s:%s) via Network", i, proto.c_str(), desc.c_str());
-							writeJSONLinking("network", i, proto, desc);
-							currentDGId = i;
-							state = DGID_STATUS::LINKED;
-							fromRF = false;
-						}
+					if (currentDGId == UNSET_DGID) {
+						std::string desc  = dgIdNetwork[i]->getDesc(i);
+						std::string proto = dgIdNetwork[i]->m_protocol;
+						LogMessage("DG-ID set to %u (%s:%s) via Network", i, proto.c_str(), desc.c_str());
+						writeJSONLinking("network", i, proto, desc);
+						currentDGId = i;
+						state = DGID_STATUS::LINKED;
+						fromRF = false;
 					}
 				}
 			}
@@ -576,10 +666,8 @@ int CDGIdGateway::run()
 
 		rptNetwork.clock(ms);
 
-		for (unsigned int i = 0U; i < 100U; i++) {
-			if (dgIdNetwork[i] != nullptr)
-				dgIdNetwork[i]->clock(ms);
-		}
+		for (const auto& it : activeNetworks)
+			it.m_network->clock(ms);
 
 		if (m_writer != nullptr)
 			m_writer->clock(ms);
@@ -627,9 +715,6 @@ int CDGIdGateway::run()
 				nPips = 2U;
 			state = DGID_STATUS::NOTLINKED;
 		}
-
-		if (ms < 5U)
-			CThread::sleep(5U);
 	}
 
 	LogInfo("DGIdGateway is stopping");
@@ -659,6 +744,16 @@ int CDGIdGateway::run()
 		delete imrs;
 	}
 
+	if (shared != nullptr) {
+		shared->close();
+		delete shared;
+	}
+
+	delete reflectors;
+
+	resolver->stop();
+	delete resolver;
+
 	return 0;
 }
 
@@ -19,6 +19,8 @@
 #ifndef	DGIdNetwork_H
 #define	DGIdNetwork_H
 
+#include "UDPSocket.h"
+
 #include <string>
 
 enum class DGID_STATUS {
@@ -49,6 +51,12 @@ public:
 
 	virtual void clock(unsigned int ms) = 0;
 
+	// Takes in what is waiting on the socket, only called once the event
+	// loop has found it readable, so that idle networks cost nothing
+	virtual void readSocket() = 0;
+
+	virtual const CUDPSocket& getSocket() const = 0;
+
 	virtual void unlink() = 0;
 
 	virtual void close() = 0;
@@ -0,0 +1,342 @@
+/*
+ *   Copyright (C) 2016-2020,2023,2024,2025,2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DNSResolver.h"
+#include "Log.h"
+
+#include <cassert>
+
+// Failed lookups are retried sooner than good ones are refreshed
+const unsigned int NEGATIVE_TTL = 60U;
+
+// Room for every reflector in a full YSFHosts.json several times over
+const unsigned int MAX_CACHE_ENTRIES = 5000U;
+
+CDNSWorker::CDNSWorker(CDNSResolver& resolver) :
+CThread(),
+m_resolver(resolver)
+{
+}
+
+void CDNSWorker::entry()
+{
+	m_resolver.process();
+}
+
+CDNSResolver::CDNSResolver(unsigned int threads, unsigned int ttl) :
+m_ttl(ttl),
+m_workers(),
+m_mutex(),
+m_queued(),
+m_resolved(),
+m_requests(),
+m_completed(),
+m_cache(),
+m_callbacks(),
+m_outstanding(0U),
+m_stopped(false)
+{
+	assert(threads > 0U);
+
+	for (unsigned int i = 0U; i < threads; i++)
+		m_workers.push_back(new CDNSWorker(*this));
+}
+
+CDNSResolver::~CDNSResolver()
+{
+	for (const auto& it : m_workers)
+		delete it;
+}
+
+bool CDNSResolver::start()
+{
+	for (const auto& it : m_workers) {
+		bool ret = it->run();
+		if (!ret) {
+			LogError("Unable to start the DNS resolver thread");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void CDNSResolver::lookup(const std::string& hostname, unsigned short port, DNSCallback callback)
+{
+	std::string k = key(hostname, port);
+
+	CDNSEntry entry;
+	if (get(k, entry)) {
+		callback(entry.m_found, entry.m_addr, entry.m_addrLen);
+		return;
+	}
+
+	// Only one lookup per name is ever in flight, later callers just wait for it
+	auto it = m_callbacks.find(k);
+	if (it != m_callbacks.end()) {
+		it->second.push_back(callback);
+		return;
+	}
+
+	m_callbacks[k].push_back(callback);
+
+	queue(hostname, port);
+}
+
+void CDNSResolver::prefetch(const std::string& hostname, unsigned short port)
+{
+	std::string k = key(hostname, port);
+
+	CDNSEntry entry;
+	if (get(k, entry))
+		return;
+
+	if (m_callbacks.count(k) > 0U)
+		return;
+
+	m_callbacks[k];
+
+	queue(hostname, port);
+}
+
+bool CDNSResolver::lookup(const std::string& hostname, unsigned short port, sockaddr_storage& addr, unsigned int& addrLen)
+{
+	std::string k = key(hostname, port);
+
+	CDNSEntry entry;
+	if (!get(k, entry)) {
+		prefetch(hostname, port);
+
+		wait();
+
+		if (!get(k, entry))
+			return false;
+	}
+
+	if (!entry.m_found)
+		return false;
+
+	addr    = entry.m_addr;
+	addrLen = entry.m_addrLen;
+
+	return true;
+}
+
+bool CDNSResolver::resolve(const std::string& hostname, unsigned short port, sockaddr_storage& addr, unsigned int& addrLen)
+{
+	std::string k = key(hostname, port);
+
+	CDNSEntry entry;
+	if (!get(k, entry)) {
+		entry = query(hostname, port);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		put(k, entry);
+	}
+
+	if (!entry.m_found)
+		return false;
+
+	addr    = entry.m_addr;
+	addrLen = entry.m_addrLen;
+
+	return true;
+}
+
+bool CDNSResolver::find(const std::string& hostname, unsigned short port, sockaddr_storage& addr, unsigned int& addrLen)
+{
+	CDNSEntry entry;
+	if (!get(key(hostname, port), entry))
+		return false;
+
+	if (!entry.m_found)
+		return false;
+
+	addr    = entry.m_addr;
+	addrLen = entry.m_addrLen;
+
+	return true;
+}
+
+void CDNSResolver::clock()
+{
+	dispatch();
+}
+
+void CDNSResolver::wait()
+{
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (m_outstanding == 0U)
+				return;
+
+			m_resolved.wait(lock, [this] { return !m_completed.empty(); });
+		}
+
+		dispatch();
+	}
+}
+
+void CDNSResolver::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopped = true;
+	}
+
+	m_queued.notify_all();
+
+	for (const auto& it : m_workers)
+		it->wait();
+}
+
+void CDNSResolver::process()
+{
+	for (;;) {
+		CDNSRequest request;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_queued.wait(lock, [this] { return m_stopped || !m_requests.empty(); });
+			if (m_stopped)
+				return;
+
+			request = m_requests.front();
+			m_requests.pop_front();
+		}
+
+		CDNSEntry entry = query(request.m_hostname, request.m_port);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			std::string k = key(request.m_hostname, request.m_port);
+			put(k, entry);
+			m_completed.push_back(std::make_pair(k, entry));
+		}
+
+		m_resolved.notify_all();
+	}
+}
+
+void CDNSResolver::queue(const std::string& hostname, unsigned short port)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		CDNSRequest request;
+		request.m_hostname = hostname;
+		request.m_port     = port;
+		m_requests.push_back(request);
+
+		m_outstanding++;
+	}
+
+	m_queued.notify_one();
+}
+
+void CDNSResolver::dispatch()
+{
+	std::vector<std::pair<std::string, CDNSEntry>> completed;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_completed.empty())
+			return;
+
+		completed.swap(m_completed);
+		m_outstanding -= (unsigned int)completed.size();
+	}
+
+	for (const auto& result : completed) {
+		const CDNSEntry& entry = result.second;
+
+		auto it = m_callbacks.find(result.first);
+		if (it == m_callbacks.end())
+			continue;
+
+		// The callbacks may queue new lookups, so take them out of the map first
+		std::vector<DNSCallback> callbacks;
+		callbacks.swap(it->second);
+		m_callbacks.erase(it);
+
+		for (const auto& callback : callbacks)
+			callback(entry.m_found, entry.m_addr, entry.m_addrLen);
+	}
+}
+
+CDNSResolver::CDNSEntry CDNSResolver::query(const std::string& hostname, unsigned short port)
+{
+	CDNSEntry entry;
+	entry.m_addrLen = 0U;
+	entry.m_found   = CUDPSocket::lookup(hostname, port, entry.m_addr, entry.m_addrLen) == 0;
+	entry.m_expires = std::chrono::steady_clock::now() + std::chrono::seconds(entry.m_found ? m_ttl : NEGATIVE_TTL);
+
+	return entry;
+}
+
+bool CDNSResolver::get(const std::string& key, CDNSEntry& entry)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_cache.find(key);
+	if (it == m_cache.end())
+		return false;
+
+	if (std::chrono::steady_clock::now() >= it->second.m_expires) {
+		m_cache.erase(it);
+		return false;
+	}
+
+	entry = it->second;
+
+	return true;
+}
+
+// Called with the mutex held. When the cache is full the expired answers
+// go first, and if that isn't enough, the one that would expire soonest.
+void CDNSResolver::put(const std::string& key, const CDNSEntry& entry)
+{
+	if ((m_cache.size() >= MAX_CACHE_ENTRIES) && (m_cache.count(key) == 0U)) {
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+		for (auto it = m_cache.begin(); it != m_cache.end();) {
+			if (now >= it->second.m_expires)
+				it = m_cache.erase(it);
+			else
+				++it;
+		}
+
+		if (m_cache.size() >= MAX_CACHE_ENTRIES) {
+			auto oldest = m_cache.begin();
+			for (auto it = m_cache.begin(); it != m_cache.end(); ++it) {
+				if (it->second.m_expires < oldest->second.m_expires)
+					oldest = it;
+			}
+
+			m_cache.erase(oldest);
+		}
+	}
+
+	m_cache[key] = entry;
+}
+
+std::string CDNSResolver::key(const std::string& hostname, unsigned short port)
+{
+	return hostname + "/" + std::to_string(port);
+}
@@ -0,0 +1,125 @@
+/*
+ *   Copyright (C) 2016-2020,2023,2024,2025,2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(DNSRESOLVER_H)
+#define	DNSRESOLVER_H
+
+#include "UDPSocket.h"
+#include "Thread.h"
+
+#include <condition_variable>
+#include <unordered_map>
+#include <functional>
+#include <utility>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <deque>
+
+typedef std::function<void(bool found, const sockaddr_storage& addr, unsigned int addrLen)> DNSCallback;
+
+class CDNSResolver;
+
+class CDNSWorker : public CThread
+{
+public:
+	CDNSWorker(CDNSResolver& resolver);
+
+	virtual void entry();
+
+private:
+	CDNSResolver& m_resolver;
+};
+
+// Resolves host names on a small pool of background threads so that
+// getaddrinfo() never runs on the main loop. Answers, good and bad, are
+// cached for a while, and the cache is kept to a fixed size. Callbacks are only ever run from clock() or wait(),
+// so they execute on the thread that owns the resolver.
+class CDNSResolver
+{
+public:
+	CDNSResolver(unsigned int threads, unsigned int ttl);
+	~CDNSResolver();
+
+	bool start();
+
+	// Runs the callback straight away if the answer is cached, otherwise
+	// queues the lookup and runs the callback later from clock().
+	void lookup(const std::string& hostname, unsigned short port, DNSCallback callback);
+
+	// Queues a lookup only to have the answer cached for later.
+	void prefetch(const std::string& hostname, unsigned short port);
+
+	// Blocks until the lookup has completed, only for use during start-up.
+	bool lookup(const std::string& hostname, unsigned short port, sockaddr_storage& addr, unsigned int& addrLen);
+
+	// Resolves on the calling thread through the cache, safe to call from any thread.
+	bool resolve(const std::string& hostname, unsigned short port, sockaddr_storage& addr, unsigned int& addrLen);
+
+	bool find(const std::string& hostname, unsigned short port, sockaddr_storage& addr, unsigned int& addrLen);
+
+	void clock();
+
+	// Blocks until every queued lookup has completed and its callback has run.
+	void wait();
+
+	void stop();
+
+private:
+	struct CDNSEntry {
+		bool                                  m_found;
+		sockaddr_storage                      m_addr;
+		unsigned int                          m_addrLen;
+		std::chrono::steady_clock::time_point m_expires;
+	};
+
+	struct CDNSRequest {
+		std::string    m_hostname;
+		unsigned short m_port;
+	};
+
+	unsigned int                                               m_ttl;
+	std::vector<CDNSWorker*>                                   m_workers;
+	std::mutex                                                 m_mutex;
+	std::condition_variable                                    m_queued;
+	std::condition_variable                                    m_resolved;
+	std::deque<CDNSRequest>                                    m_requests;
+	std::vector<std::pair<std::string, CDNSEntry>>             m_completed;
+	std::unordered_map<std::string, CDNSEntry>                 m_cache;
+	std::unordered_map<std::string, std::vector<DNSCallback>>  m_callbacks;
+	unsigned int                                               m_outstanding;
+	bool                                                       m_stopped;
+
+	friend class CDNSWorker;
+
+	void process();
+
+	void queue(const std::string& hostname, unsigned short port);
+
+	void dispatch();
+
+	CDNSEntry query(const std::string& hostname, unsigned short port);
+
+	bool get(const std::string& key, CDNSEntry& entry);
+	void put(const std::string& key, const CDNSEntry& entry);
+
+	static std::string key(const std::string& hostname, unsigned short port);
+};
+
+#endif
@@ -29,7 +29,7 @@ const char* FCS_VERSION = "MMDVM";
 
 const unsigned int BUFFER_LENGTH = 200U;
 
-CFCSNetwork::CFCSNetwork(const std::string& reflector, unsigned short port, const std::string& callsign, unsigned int rxFrequency, unsigned int txFrequency, const std::string& locator, unsigned int id, bool statc, bool debug) :
+CFCSNetwork::CFCSNetwork(const std::string& reflector, unsigned short port, const std::string& callsign, unsigned int rxFrequency, unsigned int txFrequency, const std::string& locator, unsigned int id, CDNSResolver& resolver, bool statc, bool debug) :
 m_socket(port),
 m_debug(debug),
 m_addr(),
@@ -61,7 +61,7 @@ m_state(DGID_STATUS::NOTOPEN)
 
 	char url[50U];
 	::sprintf(url, "%.6s.xreflector.net", reflector.c_str());
-	if (CUDPSocket::lookup(std::string(url), FCS_PORT, m_addr, m_addrLen) != 0)
+	if (!resolver.lookup(std::string(url), FCS_PORT, m_addr, m_addrLen))
 		m_addrLen = 0U;
 }
 
@@ -182,6 +182,12 @@ void CFCSNetwork::clock(unsigned int ms)
 		m_n = 0U;
 		m_resetTimer.stop();
 	}
+}
+
+void CFCSNetwork::readSocket()
+{
+	if (m_state == DGID_STATUS::NOTOPEN)
+		return;
 
 	unsigned char buffer[BUFFER_LENGTH];
 
@@ -255,6 +261,11 @@ unsigned int CFCSNetwork::read(unsigned int dgid, unsigned char* data)
 	return 155U;
 }
 
+const CUDPSocket& CFCSNetwork::getSocket() const
+{
+	return m_socket;
+}
+
 void CFCSNetwork::close()
 {
 	m_socket.close();
@@ -21,6 +21,7 @@
 
 #include "DGIdNetwork.h"
 #include "YSFDefines.h"
+#include "DNSResolver.h"
 #include "UDPSocket.h"
 #include "RingBuffer.h"
 #include "Timer.h"
@@ -30,7 +31,7 @@
 
 class CFCSNetwork : public CDGIdNetwork {
 public:
-	CFCSNetwork(const std::string& reflector, unsigned short port, const std::string& callsign, unsigned int rxFrequency, unsigned int txFrequency, const std::string& locator, unsigned int id, bool statc, bool debug);
+	CFCSNetwork(const std::string& reflector, unsigned short port, const std::string& callsign, unsigned int rxFrequency, unsigned int txFrequency, const std::string& locator, unsigned int id, CDNSResolver& resolver, bool statc, bool debug);
 	virtual ~CFCSNetwork();
 
 	virtual std::string getDesc(unsigned int dgId);
@@ -49,6 +50,10 @@ public:
 
 	virtual void clock(unsigned int ms);
 
+	virtual void readSocket();
+
+	virtual const CUDPSocket& getSocket() const;
+
 	virtual void unlink();
 
 	virtual void close();
@@ -17,7 +17,6 @@
 */
 
 #include "GPS.h"
-#include "YSFPayload.h"
 #include "YSFDefines.h"
 #include "Utils.h"
 #include "CRC.h"
@@ -32,30 +31,28 @@ const unsigned char LONG_GPS[] = {0x47U, 0x64U};
 
 CGPS::CGPS(CAPRSWriter* writer) :
 m_writer(writer),
-m_buffer(nullptr),
+m_buffer(),
 m_sent(false)
 {
 	assert(writer != nullptr);
-
-	m_buffer = new unsigned char[300U];
 }
 
 CGPS::~CGPS()
 {
-	delete[] m_buffer;
 }
 
-void CGPS::data(const unsigned char* source, const unsigned char* data, const CYSFFICH& fich)
+void CGPS::data(CYSFFrameView& frame)
 {
 	if (m_sent)
 		return;
 
+	const CYSFFICH& fich = frame.getFICH();
+	const unsigned char* source = frame.getSource();
+
 	unsigned char fi = fich.getFI();
 	if (fi != YSF_FI_COMMUNICATIONS)
 		return;
 
-	CYSFPayload payload;
-
 	unsigned char dt = fich.getDT();
 	unsigned char fn = fich.getFN();
 	unsigned char ft = fich.getFT();
@@ -64,7 +61,7 @@ void CGPS::data(const unsigned char* source, const unsigned char* data, const CY
 		if (fn == 0U || fn == 1U || fn == 2U)
 			return;
 
-		bool valid = payload.readVDMode1Data(data, m_buffer + (fn - 3U) * 20U);
+		bool valid = frame.readVDMode1Data(m_buffer + (fn - 3U) * 20U);
 		if (!valid)
 			return;
 
@@ -100,7 +97,7 @@ void CGPS::data(const unsigned char* source, const unsigned char* data, const CY
 		if (fn != 6U && fn != 7U)
 			return;
 
-		bool valid = payload.readVDMode2Data(data, m_buffer + (fn - 6U) * 10U);
+		bool valid = frame.readVDMode2Data(m_buffer + (fn - 6U) * 10U);
 		if (!valid)
 			return;
 
@@ -27,10 +27,17 @@
 #include <cassert>
 #include <cstring>
 
+const unsigned int BUFFER_LENGTH = 500U;
+
+// The longest IMRS frame that is sent
+const unsigned int IMRS_FRAME_LENGTH = 107U;
 
 CIMRSNetwork::CIMRSNetwork() :
 m_socket(IMRS_PORT),
 m_dgIds(),
+m_dgIdIndex(),
+m_addrIndex(),
+m_transcoder(),
 m_state(DGID_STATUS::NOTOPEN)
 {
 }
@@ -41,6 +48,8 @@ CIMRSNetwork::~CIMRSNetwork()
 
 void CIMRSNetwork::addDGId(unsigned int dgId, const std::string& name, const std::vector<IMRSDest*>& destinations, bool debug)
 {
+	assert(dgId < 100U);
+
 	IMRSDGId* f = new IMRSDGId;
 	f->m_dgId         = dgId;
 	f->m_name         = name;
@@ -48,7 +57,33 @@ void CIMRSNetwork::addDGId(unsigned int dgId, const std::string& name, const std
 	f->m_destinations = destinations;
 	f->m_debug        = debug;
 
+	// Destinations with the same DG-ID share a frame, so a frame is only
+	// copied and patched once per distinct DG-ID on each write
+	f->m_frames = new unsigned char[destinations.size() * IMRS_FRAME_LENGTH];
+
+	for (const auto& it : destinations) {
+		unsigned int n = 0U;
+		while (n < f->m_frameDGIds.size() && f->m_frameDGIds[n] != it->m_dgId)
+			n++;
+
+		if (n == f->m_frameDGIds.size())
+			f->m_frameDGIds.push_back(it->m_dgId);
+
+		UDPDatagram datagram;
+		datagram.m_buffer  = f->m_frames + n * IMRS_FRAME_LENGTH;
+		datagram.m_length  = 0U;
+		datagram.m_addr    = it->m_addr;
+		datagram.m_addrLen = it->m_addrLen;
+		f->m_datagrams.push_back(datagram);
+	}
+
 	m_dgIds.push_back(f);
+
+	m_dgIdIndex[dgId] = f;
+
+	// An address already in use stays with the DG-ID that it was first given to
+	for (const auto& it : destinations)
+		m_addrIndex.emplace(it->m_addr, f);
 }
 
 std::string CIMRSNetwork::getDesc(unsigned int dgId)
@@ -92,10 +127,16 @@ void CIMRSNetwork::write(unsigned int dgId, const unsigned char* data)
 	if (ptr == nullptr)
 		return;
 
-	CUtils::dump(1U, "YSF Data Received", data, 155U);
+	if (ptr->m_datagrams.empty())
+		return;
+
+	if (ptr->m_debug)
+		CUtils::dump(1U, "YSF Data Received", data, 155U);
 
 	CYSFFICH fich;
-	fich.decode(data + 35U);
+	bool valid = fich.decode(data + 35U);
+	if (!valid)
+		return;
 
 	switch (fich.getFI()) {
 	case YSF_FI_HEADER:
@@ -115,7 +156,8 @@ bool CIMRSNetwork::writeHeaderTrailer(IMRSDGId* ptr, CYSFFICH& fich, const unsig
 	assert(ptr != nullptr);
 	assert(data != nullptr);
 
-	unsigned char buffer[200U];
+	// Built in the first frame, the copies are made in writeFrames()
+	unsigned char* buffer = ptr->m_frames;
 
 	if (fich.getFI() == YSF_FI_HEADER) {
 		buffer[0U] = 0x11U;
@@ -125,31 +167,16 @@ bool CIMRSNetwork::writeHeaderTrailer(IMRSDGId* ptr, CYSFFICH& fich, const unsig
 	}
 
 	// Copy the sequence number LE (2 bytes)
-	buffer[1U] = (ptr->m_seqNo << 0) & 0xFFU;
-	buffer[2U] = (ptr->m_seqNo << 8) & 0xFFU;
+	buffer[1U] = (ptr->m_seqNo >> 0) & 0xFFU;
+	buffer[2U] = (ptr->m_seqNo >> 8) & 0xFFU;
 
 	// Copy CSD1 and CSD2 (40 bytes)
 	CYSFPayload payload;
 	payload.readHeaderData(data + 35U, buffer + 7U);
 
 	fich.getRaw(buffer + 3U);
-	CUtils::dump(1U, "IMRS Network Data Sent", buffer, 47U);
-
-	readHeaderTrailer(ptr, fich, buffer);
 
-#ifdef notdef
-	for (std::vector<IMRSDest*>::const_iterator it = ptr->m_destinations.begin(); it != ptr->m_destinations.end(); ++it) {
-		// Set the correct DG-ID for this destination
-		fich.setDGId((*it)->m_dgId);
-		// Copy the raw FICH
-		fich.getRaw(buffer + 3U);
-
-		if (ptr->m_debug)
-			CUtils::dump(1U, "IMRS Network Data Sent", buffer, 47U);
-
-		m_socket.write(buffer, 47U, (*it)->m_addr, (*it)->m_addrLen);
-	}
-#endif
+	writeFrames(ptr, 47U);
 
 	ptr->m_seqNo++;
 
@@ -161,94 +188,56 @@ bool CIMRSNetwork::writeData(IMRSDGId* ptr, CYSFFICH& fich, const unsigned char*
 	assert(ptr != nullptr);
 	assert(data != nullptr);
 
-	unsigned char buffer[200U];
-	unsigned int length = 0U;
+	// Built in the first frame, the copies are made in writeFrames()
+	unsigned char* buffer = ptr->m_frames;
 
 	buffer[0U] = 0x22U;
 
 	// Copy the sequence number LE (2 bytes)
-	buffer[1U] = (ptr->m_seqNo << 0) & 0xFFU;
-	buffer[2U] = (ptr->m_seqNo << 8) & 0xFFU;
+	buffer[1U] = (ptr->m_seqNo >> 0) & 0xFFU;
+	buffer[2U] = (ptr->m_seqNo >> 8) & 0xFFU;
 
-	unsigned char dt = fich.getDT();
-	unsigned char ft = fich.getFT();
-	unsigned char fn = fich.getFN();
-
-	CYSFPayload payload;
-
-	// Create the header
-	switch (dt) {
-	case YSF_DT_VD_MODE1:
-		// Copy the DCH (20 bytes)
-		payload.readVDMode1Data(data + 35U, buffer + 7U);
-		// Copy the audio
-		::memcpy(buffer + 27U + 0U,  data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 9U,  9U);
-		::memcpy(buffer + 27U + 9U,  data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 27U, 9U);
-		::memcpy(buffer + 27U + 18U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 45U, 9U);
-		::memcpy(buffer + 27U + 27U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 63U, 9U);
-		::memcpy(buffer + 27U + 36U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 81U, 9U);
-		length = 72U;
-		break;
-	case YSF_DT_DATA_FR_MODE:
-		// Copy the data
-		::memcpy(buffer + 17U + 0U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 0U, 90U);
-		length = 107U;
-		break;
-	case YSF_DT_VD_MODE2:
-		// Copy the DCH (10 bytes)
-		payload.readVDMode2Data(data + 35U, buffer + 7U);
-		// Copy the audio
-		::memcpy(buffer + 17U + 0U,  data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 5U,  13U);
-		::memcpy(buffer + 17U + 13U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 23U, 13U);
-		::memcpy(buffer + 17U + 26U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 41U, 13U);
-		::memcpy(buffer + 17U + 39U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 59U, 13U);
-		::memcpy(buffer + 17U + 52U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 77U, 13U);
-		length = 82U;
-		break;
-	case YSF_DT_VOICE_FR_MODE:
-		if (fn == 0U && ft == 1U) {
-			// Copy the DCH (20 bytes)
-			payload.readVoiceFRModeData(data + 35U, buffer + 7U);
-			// Copy the audio
-			::memcpy(buffer + 27U + 0U,  data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 54U, 18U);
-			::memcpy(buffer + 27U + 18U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 72U, 18U);
-			length = 107U;
-		} else {
-			// Copy the audio
-			::memcpy(buffer + 17U + 0U,  data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 0U,  18U);
-			::memcpy(buffer + 17U + 18U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 18U, 18U);
-			::memcpy(buffer + 17U + 36U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 36U, 18U);
-			::memcpy(buffer + 17U + 54U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 54U, 18U);
-			::memcpy(buffer + 17U + 72U, data + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 72U, 18U);
-			length = 107U;
-		}
-		break;
-	default:
+	// The DCH and the audio
+	unsigned int length = m_transcoder.toIMRS(fich, data + 35U, buffer);
+	if (length == 0U)
 		return false;
-	}
 
 	fich.getRaw(buffer + 3U);
-	CUtils::dump(1U, "IMRS Network Data Sent", buffer, length);
 
-	readData(ptr, fich, buffer);
+	writeFrames(ptr, length);
 
-#ifdef notdef
-	for (std::vector<IMRSDest*>::const_iterator it = ptr->m_destinations.begin(); it != ptr->m_destinations.end(); ++it) {
-		// Set the correct DG-ID for this destination
-		fich.setDGId((*it)->m_dgId);
-		// Copy the raw FICH
-		fich.getRaw(buffer + 3U);
+	ptr->m_seqNo++;
 
-		if (ptr->m_debug)
-			CUtils::dump(1U, "IMRS Network Data Sent", buffer, length);
+	return true;
+}
+
+void CIMRSNetwork::writeFrames(IMRSDGId* ptr, unsigned int length)
+{
+	assert(ptr != nullptr);
+	assert(length <= IMRS_FRAME_LENGTH);
+
+	const unsigned char* frame = ptr->m_frames;
 
-		m_socket.write(buffer, length, (*it)->m_addr, (*it)->m_addrLen);
+	// Only the DG-ID in the raw FICH differs between the frames
+	unsigned char fich3 = frame[6U] & 0x80U;
+
+	for (unsigned int i = ptr->m_frameDGIds.size(); i > 0U; i--) {
+		unsigned char* copy = ptr->m_frames + (i - 1U) * IMRS_FRAME_LENGTH;
+		if (i > 1U)
+			::memcpy(copy, frame, length);
+
+		copy[6U] = fich3 | (ptr->m_frameDGIds[i - 1U] & 0x7FU);
 	}
-#endif
 
-	ptr->m_seqNo++;
+	for (auto& it : ptr->m_datagrams) {
+		it.m_length = length;
 
-	return true;
+		if (ptr->m_debug)
+			CUtils::dump(1U, "IMRS Network Data Sent", it.m_buffer, length);
+	}
+
+	// All of the destinations in one batched write
+	m_socket.write(ptr->m_datagrams.data(), ptr->m_datagrams.size());
 }
 
 void CIMRSNetwork::readHeaderTrailer(IMRSDGId* ptr, CYSFFICH& fich, const unsigned char* data)
@@ -287,16 +276,15 @@ void CIMRSNetwork::readHeaderTrailer(IMRSDGId* ptr, CYSFFICH& fich, const unsign
 	CYSFPayload payload;
 	payload.writeHeaderData(data + 7U, buffer + 35U);
 
-	CUtils::dump("YSF Data Transmitted", buffer, 155U);
+	if (ptr->m_debug)
+		CUtils::dump(1U, "YSF Data Transmitted", buffer, 155U);
 
-#ifdef notdef
 	unsigned char len = 155U;
 	ptr->m_buffer.addData(&len, 1U);
 	ptr->m_buffer.addData(buffer, len);
-#endif
 }
 
-void CIMRSNetwork::readData(IMRSDGId* ptr, CYSFFICH& fich, const unsigned char* data)
+void CIMRSNetwork::readData(IMRSDGId* ptr, CYSFFICH& fich, const unsigned char* data, unsigned int length)
 {
 	assert(ptr != nullptr);
 	assert(data != nullptr);
@@ -316,67 +304,17 @@ void CIMRSNetwork::readData(IMRSDGId* ptr, CYSFFICH& fich, const unsigned char*
 
 	fich.encode(buffer + 35U);
 
-	unsigned char dt = fich.getDT();
-	unsigned char fn = fich.getFN();
-	unsigned char ft = fich.getFT();
-
-	CYSFPayload payload;
-
-	// Create the header
-	switch (dt) {
-	case YSF_DT_VD_MODE1:
-		// Copy the DCH
-		payload.writeVDMode1Data(data + 7U, buffer + 35U);
-		// Copy the audio
-		::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 9U,  data + 27U + 0U,  9U);
-		::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 27U, data + 27U + 9U,  9U);
-		::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 45U, data + 27U + 18U, 9U);
-		::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 63U, data + 27U + 27U, 9U);
-		::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 81U, data + 27U + 36U, 9U);
-		break;
-	case YSF_DT_DATA_FR_MODE:
-		// Copy the data
-		::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 0U, data + 17U + 0U, 90U);
-		break;
-	case YSF_DT_VD_MODE2:
-		// Copy the DCH
-		payload.writeVDMode2Data(data + 7U, buffer + 35U);
-		// Copy the audio
-		::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 5U,  data + 17U + 0U,  13U);
-		::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 23U, data + 17U + 13U, 13U);
-		::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 41U, data + 17U + 26U, 13U);
-		::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 59U, data + 17U + 39U, 13U);
-		::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 77U, data + 17U + 52U, 13U);
-		break;
-	case YSF_DT_VOICE_FR_MODE:
-		if (fn == 0U && ft == 1U) {
-			// Copy the DCH
-			payload.writeVoiceFRModeData(data + 7U, buffer + 35U);
-			// nullptr the unused section
-			::memset(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 45U, 0x00U, 9U);
-			// Copy the audio
-			::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 54U, data + 27U + 0U,  18U);
-			::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 72U, data + 27U + 18U, 18U);
-		} else {
-			// Copy the audio
-			::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 0U,  data + 17U + 0U,  18U);
-			::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 18U, data + 17U + 18U, 18U);
-			::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 36U, data + 17U + 36U, 18U);
-			::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 54U, data + 17U + 54U, 18U);
-			::memcpy(buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES + 72U, data + 17U + 72U, 18U);
-		}
-		break;
-	default:
+	// The DCH and the audio
+	bool valid = m_transcoder.fromIMRS(fich, data, length, buffer + 35U);
+	if (!valid)
 		return;
-	}
 
-	CUtils::dump("YSF Data Transmitted", buffer, 155U);
+	if (ptr->m_debug)
+		CUtils::dump(1U, "YSF Data Transmitted", buffer, 155U);
 
-#ifdef notdef
 	unsigned char len = 155U;
 	ptr->m_buffer.addData(&len, 1U);
 	ptr->m_buffer.addData(buffer, len);
-#endif
 }
 
 void CIMRSNetwork::link()
@@ -389,18 +327,35 @@ void CIMRSNetwork::unlink()
 
 void CIMRSNetwork::clock(unsigned int ms)
 {
-	unsigned char buffer[500U];
+}
 
-	sockaddr_storage addr;
-	unsigned int addrLen;
-	int length = m_socket.read(buffer, 500U, addr, addrLen);
-	if (length <= 0)
-		return;
+void CIMRSNetwork::readSocket()
+{
+	unsigned char buffers[UDP_BATCH_SIZE][BUFFER_LENGTH];
+	UDPDatagram datagrams[UDP_BATCH_SIZE];
+
+	for (unsigned int i = 0U; i < UDP_BATCH_SIZE; i++) {
+		datagrams[i].m_buffer = buffers[i];
+		datagrams[i].m_length = BUFFER_LENGTH;
+	}
+
+	// Take everything that is waiting, from all of the IMRS peers, in one call
+	int n = m_socket.read(datagrams, UDP_BATCH_SIZE);
+
+	for (int i = 0; i < n; i++)
+		receive(datagrams[i].m_buffer, datagrams[i].m_length, datagrams[i].m_addr, datagrams[i].m_addrLen);
+}
+
+void CIMRSNetwork::receive(const unsigned char* buffer, unsigned int length, const sockaddr_storage& addr, unsigned int addrLen)
+{
+	assert(buffer != nullptr);
 
 	if (addrLen == 0U)
 		return;
 
-	CUtils::dump(1U, "IMRS Network Data Received", buffer, length);
+	// The shortest frame is a header or a trailer
+	if (length < 47U)
+		return;
 
 	IMRSDGId* ptr = find(addr);
 	if (ptr == nullptr)
@@ -419,7 +374,7 @@ void CIMRSNetwork::clock(unsigned int ms)
 		readHeaderTrailer(ptr, fich, buffer);
 		break;
 	case YSF_FI_COMMUNICATIONS:
-		readData(ptr, fich, buffer);
+		readData(ptr, fich, buffer, length);
 		break;
 	default:
 		break;
@@ -445,6 +400,11 @@ unsigned int CIMRSNetwork::read(unsigned int dgId, unsigned char* data)
 	return len;
 }
 
+const CUDPSocket& CIMRSNetwork::getSocket() const
+{
+	return m_socket;
+}
+
 void CIMRSNetwork::close()
 {
 	LogMessage("Closing IMRS network connection");
@@ -456,22 +416,17 @@ void CIMRSNetwork::close()
 
 IMRSDGId* CIMRSNetwork::find(const sockaddr_storage& addr) const
 {
-	for (std::vector<IMRSDGId*>::const_iterator it1 = m_dgIds.begin(); it1 != m_dgIds.end(); ++it1) {
-		for (std::vector<IMRSDest*>::const_iterator it2 = (*it1)->m_destinations.begin(); it2 != (*it1)->m_destinations.end(); ++it2) {
-			if (CUDPSocket::match(addr, (*it2)->m_addr))
-				return *it1;
-		}
-	}
+	auto it = m_addrIndex.find(addr);
+	if (it == m_addrIndex.end())
+		return nullptr;
 
-	return nullptr;
+	return it->second;
 }
 
 IMRSDGId* CIMRSNetwork::find(unsigned int dgId) const
 {
-	for (std::vector<IMRSDGId*>::const_iterator it = m_dgIds.begin(); it != m_dgIds.end(); ++it) {
-		if (dgId == (*it)->m_dgId)
-			return *it;
-	}
+	if (dgId >= 100U)
+		return nullptr;
 
-	return nullptr;
+	return m_dgIdIndex[dgId];
 }
@@ -19,6 +19,7 @@
 #ifndef	IMRSNetwork_H
 #define	IMRSNetwork_H
 
+#include "IMRSTranscoder.h"
 #include "DGIdNetwork.h"
 #include "YSFDefines.h"
 #include "UDPSocket.h"
@@ -26,6 +27,7 @@
 #include "YSFDefines.h"
 #include "YSFFICH.h"
 
+#include <unordered_map>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -46,7 +48,10 @@ public:
 	m_dest(nullptr),
 	m_destinations(),
 	m_debug(false),
-	m_buffer(1000U, "IMRS Buffer")
+	m_buffer(5000U, "IMRS Buffer"),
+	m_frameDGIds(),
+	m_frames(nullptr),
+	m_datagrams()
 	{
 		m_source = new unsigned char[YSF_CALLSIGN_LENGTH];
 		m_dest   = new unsigned char[YSF_CALLSIGN_LENGTH];
@@ -56,6 +61,7 @@ public:
 	{
 		delete[] m_source;
 		delete[] m_dest;
+		delete[] m_frames;
 	}
 
 	unsigned int               m_dgId;
@@ -66,6 +72,11 @@ public:
 	std::vector<IMRSDest*>     m_destinations;
 	bool                       m_debug;
 	CRingBuffer<unsigned char> m_buffer;
+	// One outgoing frame per distinct destination DG-ID, and one datagram
+	// per destination pointing at the frame with its DG-ID
+	std::vector<unsigned int>  m_frameDGIds;
+	unsigned char*             m_frames;
+	std::vector<UDPDatagram>   m_datagrams;
 };
 
 class CIMRSNetwork : public CDGIdNetwork {
@@ -91,6 +102,10 @@ public:
 
 	virtual void clock(unsigned int ms);
 
+	virtual void readSocket();
+
+	virtual const CUDPSocket& getSocket() const;
+
 	virtual void unlink();
 
 	virtual void close();
@@ -98,16 +113,23 @@ public:
 private:
 	CUDPSocket             m_socket;
 	std::vector<IMRSDGId*> m_dgIds;
+	// Direct lookups by DG-ID, and by the address of any of the destinations
+	IMRSDGId*              m_dgIdIndex[100U];
+	std::unordered_map<sockaddr_storage, IMRSDGId*, CUDPAddressHash, CUDPAddressEqual> m_addrIndex;
+	CIMRSTranscoder        m_transcoder;
 	DGID_STATUS            m_state;
 
 	IMRSDGId* find(const sockaddr_storage& address) const;
 	IMRSDGId* find(unsigned int dgId) const;
 
+	void receive(const unsigned char* buffer, unsigned int length, const sockaddr_storage& addr, unsigned int addrLen);
+
 	bool writeHeaderTrailer(IMRSDGId* ptr, CYSFFICH& fich, const unsigned char* data);
 	bool writeData(IMRSDGId* ptr, CYSFFICH& fich, const unsigned char* data);
+	void writeFrames(IMRSDGId* ptr, unsigned int length);
 
 	void readHeaderTrailer(IMRSDGId* ptr, CYSFFICH& fich, const unsigned char* data);
-	void readData(IMRSDGId* ptr, CYSFFICH& fich, const unsigned char* data);
+	void readData(IMRSDGId* ptr, CYSFFICH& fich, const unsigned char* data, unsigned int length);
 };
 
 #endif
@@ -0,0 +1,209 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+#include "IMRSTranscoder.h"
+#include "YSFDefines.h"
+
+#include <cassert>
+#include <cstring>
+
+// The DCH starts straight after the sequence number and raw FICH
+const unsigned int IMRS_DCH_OFFSET = 7U;
+
+const unsigned int NO_LAYOUT = 5U;
+
+// A run of bytes, the YSF offset is from after the sync and FICH
+struct IMRSSlice {
+	unsigned int m_ysf;
+	unsigned int m_imrs;
+	unsigned int m_length;
+};
+
+// Where everything lies for one DT. The YSF payload is made of five 18
+// byte blocks, and the encoded DCH and the audio take up the same run in
+// each block, so the gather lists are built from the first block. For the
+// encoded DCH the IMRS offset is into the contiguous encoded DCH.
+struct IMRSLayout {
+	unsigned int m_length;
+	unsigned int m_dchLength;
+	bool (CYSFPayload::*m_read)(const unsigned char*, unsigned char*);
+	void (CYSFPayload::*m_write)(const unsigned char*, unsigned char*);
+	unsigned int m_encodedLength;
+	unsigned int m_encodedCount;
+	IMRSSlice    m_encoded[5U];
+	unsigned int m_audioStart;
+	unsigned int m_audioEnd;
+	unsigned int m_audioCount;
+	IMRSSlice    m_audio[5U];
+	unsigned int m_clearOffset;
+	unsigned int m_clearLength;
+
+	constexpr IMRSLayout(unsigned int length, unsigned int dchLength,
+						 bool (CYSFPayload::*read)(const unsigned char*, unsigned char*), void (CYSFPayload::*write)(const unsigned char*, unsigned char*),
+						 unsigned int encodedCount, unsigned int encodedLength,
+						 unsigned int audioCount, unsigned int audioOffset, unsigned int audioLength, unsigned int audioStart,
+						 unsigned int clearOffset, unsigned int clearLength) :
+	m_length(length),
+	m_dchLength(dchLength),
+	m_read(read),
+	m_write(write),
+	m_encodedLength(encodedCount * encodedLength),
+	m_encodedCount(encodedCount),
+	m_encoded(),
+	m_audioStart(audioStart),
+	m_audioEnd(audioStart + audioCount * audioLength),
+	m_audioCount(audioCount),
+	m_audio(),
+	m_clearOffset(clearOffset),
+	m_clearLength(clearLength)
+	{
+		for (unsigned int i = 0U; i < 5U; i++) {
+			m_encoded[i] = i < encodedCount ? IMRSSlice{i * 18U, i * encodedLength, encodedLength} : IMRSSlice{0U, 0U, 0U};
+			m_audio[i]   = i < audioCount ? IMRSSlice{audioOffset + i * 18U, audioStart + i * audioLength, audioLength} : IMRSSlice{0U, 0U, 0U};
+		}
+
+		// Whole blocks of audio are contiguous in both frames, so one copy does
+		if (audioLength == 18U && audioCount > 1U) {
+			m_audio[0U].m_length = audioCount * audioLength;
+			for (unsigned int i = 1U; i < 5U; i++)
+				m_audio[i] = IMRSSlice{0U, 0U, 0U};
+			m_audioCount = 1U;
+		}
+	}
+};
+
+static constexpr IMRSLayout LAYOUTS[] = {
+	// YSF_DT_VD_MODE1, a 20 byte DCH and 9 bytes of audio per block
+	IMRSLayout(72U, 20U, &CYSFPayload::readVDMode1Data, &CYSFPayload::writeVDMode1Data, 5U, 9U, 5U, 9U, 9U, 27U, 0U, 0U),
+	// YSF_DT_VD_MODE2, a 10 byte DCH and 13 bytes of audio per block
+	IMRSLayout(82U, 10U, &CYSFPayload::readVDMode2Data, &CYSFPayload::writeVDMode2Data, 5U, 5U, 5U, 5U, 13U, 17U, 0U, 0U),
+	// YSF_DT_VOICE_FR_MODE, all audio
+	IMRSLayout(107U, 0U, nullptr, nullptr, 0U, 0U, 5U, 0U, 18U, 17U, 0U, 0U),
+	// YSF_DT_VOICE_FR_MODE, the first frame, a 20 byte DCH, an empty 9 bytes and then audio
+	IMRSLayout(107U, 20U, &CYSFPayload::readVoiceFRModeData, &CYSFPayload::writeVoiceFRModeData, 1U, 45U, 2U, 54U, 18U, 27U, 45U, 9U),
+	// YSF_DT_DATA_FR_MODE, passed through untouched
+	IMRSLayout(107U, 0U, nullptr, nullptr, 0U, 0U, 5U, 0U, 18U, 17U, 0U, 0U)
+};
+
+static_assert(sizeof(LAYOUTS) / sizeof(LAYOUTS[0U]) == NO_LAYOUT, "One layout per DCH cache");
+
+static unsigned int findLayout(const CYSFFICH& fich)
+{
+	switch (fich.getDT()) {
+	case YSF_DT_VD_MODE1:
+		return 0U;
+	case YSF_DT_VD_MODE2:
+		return 1U;
+	case YSF_DT_VOICE_FR_MODE:
+		return (fich.getFN() == 0U && fich.getFT() == 1U) ? 3U : 2U;
+	case YSF_DT_DATA_FR_MODE:
+		return 4U;
+	default:
+		return NO_LAYOUT;
+	}
+}
+
+CIMRSTranscoder::CIMRSTranscoder() :
+m_payload(),
+m_decoded(),
+m_encoded()
+{
+}
+
+CIMRSTranscoder::~CIMRSTranscoder()
+{
+}
+
+unsigned int CIMRSTranscoder::toIMRS(const CYSFFICH& fich, const unsigned char* data, unsigned char* frame)
+{
+	assert(data != nullptr);
+	assert(frame != nullptr);
+
+	unsigned int n = findLayout(fich);
+	if (n == NO_LAYOUT)
+		return 0U;
+
+	const IMRSLayout& layout = LAYOUTS[n];
+
+	const unsigned char* payload = data + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
+
+	if (layout.m_dchLength > 0U) {
+		unsigned char encoded[45U];
+		for (unsigned int i = 0U; i < layout.m_encodedCount; i++)
+			::memcpy(encoded + layout.m_encoded[i].m_imrs, payload + layout.m_encoded[i].m_ysf, layout.m_encoded[i].m_length);
+
+		IMRSDCH& dch = m_decoded[n][fich.getFN()];
+		if (dch.m_valid && ::memcmp(dch.m_encoded, encoded, layout.m_encodedLength) == 0) {
+			::memcpy(frame + IMRS_DCH_OFFSET, dch.m_dch, layout.m_dchLength);
+		} else if ((m_payload.*layout.m_read)(data, frame + IMRS_DCH_OFFSET)) {
+			::memcpy(dch.m_dch, frame + IMRS_DCH_OFFSET, layout.m_dchLength);
+			::memcpy(dch.m_encoded, encoded, layout.m_encodedLength);
+			dch.m_valid = true;
+		} else {
+			::memset(frame + IMRS_DCH_OFFSET, 0x00U, layout.m_dchLength);
+		}
+	}
+
+	// Nothing is carried before or after the audio
+	::memset(frame + IMRS_DCH_OFFSET + layout.m_dchLength, 0x00U, layout.m_audioStart - IMRS_DCH_OFFSET - layout.m_dchLength);
+	::memset(frame + layout.m_audioEnd, 0x00U, layout.m_length - layout.m_audioEnd);
+
+	for (unsigned int i = 0U; i < layout.m_audioCount; i++)
+		::memcpy(frame + layout.m_audio[i].m_imrs, payload + layout.m_audio[i].m_ysf, layout.m_audio[i].m_length);
+
+	return layout.m_length;
+}
+
+bool CIMRSTranscoder::fromIMRS(const CYSFFICH& fich, const unsigned char* frame, unsigned int length, unsigned char* data)
+{
+	assert(frame != nullptr);
+	assert(data != nullptr);
+
+	unsigned int n = findLayout(fich);
+	if (n == NO_LAYOUT)
+		return false;
+
+	const IMRSLayout& layout = LAYOUTS[n];
+	if (length < layout.m_length)
+		return false;
+
+	unsigned char* payload = data + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
+
+	if (layout.m_dchLength > 0U) {
+		IMRSDCH& dch = m_encoded[n][fich.getFN()];
+		if (!dch.m_valid || ::memcmp(dch.m_dch, frame + IMRS_DCH_OFFSET, layout.m_dchLength) != 0) {
+			(m_payload.*layout.m_write)(frame + IMRS_DCH_OFFSET, data);
+
+			for (unsigned int i = 0U; i < layout.m_encodedCount; i++)
+				::memcpy(dch.m_encoded + layout.m_encoded[i].m_imrs, payload + layout.m_encoded[i].m_ysf, layout.m_encoded[i].m_length);
+
+			::memcpy(dch.m_dch, frame + IMRS_DCH_OFFSET, layout.m_dchLength);
+			dch.m_valid = true;
+		} else {
+			for (unsigned int i = 0U; i < layout.m_encodedCount; i++)
+				::memcpy(payload + layout.m_encoded[i].m_ysf, dch.m_encoded + layout.m_encoded[i].m_imrs, layout.m_encoded[i].m_length);
+		}
+	}
+
+	if (layout.m_clearLength > 0U)
+		::memset(payload + layout.m_clearOffset, 0x00U, layout.m_clearLength);
+
+	for (unsigned int i = 0U; i < layout.m_audioCount; i++)
+		::memcpy(payload + layout.m_audio[i].m_ysf, frame + layout.m_audio[i].m_imrs, layout.m_audio[i].m_length);
+
+	return true;
+}
@@ -0,0 +1,53 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+#ifndef	IMRSTranscoder_H
+#define	IMRSTranscoder_H
+
+#include "YSFPayload.h"
+#include "YSFFICH.h"
+
+// Converts the DCH and audio of a communications frame between the YSF
+// payload and an IMRS frame, using a layout for each DT. The last DCH seen
+// for each layout and FN is kept in each direction, so a DCH that repeats
+// from one superframe to the next is not decoded or encoded again.
+class CIMRSTranscoder {
+public:
+	CIMRSTranscoder();
+	~CIMRSTranscoder();
+
+	// The data starts at the YSF sync, the frame is the whole IMRS frame, of
+	// which only the bytes from the DCH onwards are written. Returns the
+	// length of the IMRS frame, or zero if the DT is not supported.
+	unsigned int toIMRS(const CYSFFICH& fich, const unsigned char* data, unsigned char* frame);
+
+	// The reverse, the YSF sync and FICH are not written.
+	bool fromIMRS(const CYSFFICH& fich, const unsigned char* frame, unsigned int length, unsigned char* data);
+
+private:
+	struct IMRSDCH {
+		bool          m_valid;
+		unsigned char m_dch[20U];
+		unsigned char m_encoded[45U];
+	};
+
+	CYSFPayload m_payload;
+	IMRSDCH     m_decoded[5U][8U];
+	IMRSDCH     m_encoded[5U][8U];
+};
+
+#endif
@@ -32,6 +32,8 @@
 
 extern void Log(unsigned int level, const char* fmt, ...);
 
+extern bool LogEnabled(unsigned int level);
+
 extern void LogInitialise(unsigned int displayLevel, unsigned int mqttLevel);
 extern void LogFinalise();
 
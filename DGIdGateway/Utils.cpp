@@ -24,18 +24,23 @@
 #include <unistd.h>
 #endif
 
-void CUtils::dump(const std::string& title, const unsigned char* data, unsigned int length)
+void CUtils::dump(const char* title, const unsigned char* data, unsigned int length)
 {
+	assert(title != nullptr);
 	assert(data != nullptr);
 
 	dump(2U, title, data, length);
 }
 
-void CUtils::dump(int level, const std::string& title, const unsigned char* data, unsigned int length)
+void CUtils::dump(int level, const char* title, const unsigned char* data, unsigned int length)
 {
+	assert(title != nullptr);
 	assert(data != nullptr);
 
-	::Log(level, "%s", title.c_str());
+	if (!LogEnabled(level))
+		return;
+
+	::Log(level, "%s", title);
 
 	unsigned int offset = 0U;
 
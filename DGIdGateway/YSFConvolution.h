@@ -32,15 +32,17 @@ public:
 	void decode(uint8_t s0, uint8_t s1);
 	void chainback(unsigned char* out, unsigned int nBits);
 
+	uint16_t getMetric() const;
+
 	void encode(const unsigned char* in, unsigned char* out, unsigned int nBits) const;
 
 private:
-	uint16_t* m_metrics1;
-	uint16_t* m_metrics2;
+	uint16_t  m_metrics1[16U];
+	uint16_t  m_metrics2[16U];
 	uint16_t* m_oldMetrics;
 	uint16_t* m_newMetrics;
-	uint64_t* m_decisions;
-	uint64_t* m_dp;
+	uint16_t  m_decisions[180U];
+	uint16_t* m_dp;
 };
 
 #endif
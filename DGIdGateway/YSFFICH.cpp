@@ -17,62 +17,124 @@
  */
 
 #include "YSFConvolution.h"
+#include "YSFInterleaver.h"
 #include "YSFDefines.h"
 #include "Golay24128.h"
 #include "YSFFICH.h"
 #include "CRC.h"
 #include "Log.h"
 
+#include <cstdint>
 #include <cstdio>
 #include <cassert>
 #include <cstring>
 
-const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
-
-#define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
-#define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
-
-const unsigned int INTERLEAVE_TABLE[] = {
-   0U, 40U,  80U, 120U, 160U,
-   2U, 42U,  82U, 122U, 162U,
-   4U, 44U,  84U, 124U, 164U,
-   6U, 46U,  86U, 126U, 166U,
-   8U, 48U,  88U, 128U, 168U,
-  10U, 50U,  90U, 130U, 170U,
-  12U, 52U,  92U, 132U, 172U,
-  14U, 54U,  94U, 134U, 174U,
-  16U, 56U,  96U, 136U, 176U,
-  18U, 58U,  98U, 138U, 178U,
-  20U, 60U, 100U, 140U, 180U,
-  22U, 62U, 102U, 142U, 182U,
-  24U, 64U, 104U, 144U, 184U,
-  26U, 66U, 106U, 146U, 186U,
-  28U, 68U, 108U, 148U, 188U,
-  30U, 70U, 110U, 150U, 190U,
-  32U, 72U, 112U, 152U, 192U,
-  34U, 74U, 114U, 154U, 194U,
-  36U, 76U, 116U, 156U, 196U,
-  38U, 78U, 118U, 158U, 198U};
+constexpr CYSFInterleaver<5U, 20U> INTERLEAVER;
+
+// Within a transmission only the frame number in the FICH changes, so the
+// same few raw FICH blocks come round again and again. Decodes are kept in a
+// small cache keyed on the raw block, so that the usual case is a compare
+// rather than a Viterbi and Golay decode. It holds two full cycles of frame
+// numbers, the oldest entry is replaced, and each thread has its own.
+const unsigned int FICH_CACHE_SIZE = 16U;
+
+struct CFICHCacheEntry {
+	uint32_t      m_hash;
+	unsigned char m_raw[YSF_FICH_LENGTH_BYTES];
+	unsigned char m_fich[6U];
+	bool          m_valid;
+	bool          m_exact;
+	bool          m_used;
+};
+
+static thread_local CFICHCacheEntry FICH_CACHE[FICH_CACHE_SIZE];
+static thread_local unsigned int    FICH_CACHE_NEXT = 0U;
+
+// Adds the CRC to the FICH and encodes it
+static void encodeFICH(unsigned char* fich, unsigned char* bytes)
+{
+	CCRC::addCCITT16(fich, 6U);
 
-CYSFFICH::CYSFFICH(const CYSFFICH& fich) :
-m_fich(nullptr)
+	unsigned int b0 = ((fich[0U] << 4) & 0xFF0U) | ((fich[1U] >> 4) & 0x00FU);
+	unsigned int b1 = ((fich[1U] << 8) & 0xF00U) | ((fich[2U] >> 0) & 0x0FFU);
+	unsigned int b2 = ((fich[3U] << 4) & 0xFF0U) | ((fich[4U] >> 4) & 0x00FU);
+	unsigned int b3 = ((fich[4U] << 8) & 0xF00U) | ((fich[5U] >> 0) & 0x0FFU);
+
+	unsigned int c0 = CGolay24128::encode24128(b0);
+	unsigned int c1 = CGolay24128::encode24128(b1);
+	unsigned int c2 = CGolay24128::encode24128(b2);
+	unsigned int c3 = CGolay24128::encode24128(b3);
+
+	unsigned char conv[13U];
+	conv[0U]  = (c0 >> 16) & 0xFFU;
+	conv[1U]  = (c0 >> 8) & 0xFFU;
+	conv[2U]  = (c0 >> 0) & 0xFFU;
+	conv[3U]  = (c1 >> 16) & 0xFFU;
+	conv[4U]  = (c1 >> 8) & 0xFFU;
+	conv[5U]  = (c1 >> 0) & 0xFFU;
+	conv[6U]  = (c2 >> 16) & 0xFFU;
+	conv[7U]  = (c2 >> 8) & 0xFFU;
+	conv[8U]  = (c2 >> 0) & 0xFFU;
+	conv[9U]  = (c3 >> 16) & 0xFFU;
+	conv[10U] = (c3 >> 8) & 0xFFU;
+	conv[11U] = (c3 >> 0) & 0xFFU;
+	conv[12U] = 0x00U;
+
+	CYSFConvolution convolution;
+	unsigned char convolved[25U];
+	convolution.encode(conv, convolved, 100U);
+
+	INTERLEAVER.interleave(convolved, bytes);
+}
+
+// The CRC, Golay and convolutional codes are all linear, apart from the CRC
+// being inverted, so changing some of the DG-ID bits flips the same encoded
+// bits whatever the rest of the FICH holds. These are the encoded bits that
+// each change of DG-ID flips, worked out from the encoder on first use.
+struct CFICHDGIdDeltas {
+	unsigned char m_delta[128U][YSF_FICH_LENGTH_BYTES];
+
+	CFICHDGIdDeltas() :
+	m_delta()
+	{
+		unsigned char fich[6U] = { 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U };
+
+		unsigned char zero[YSF_FICH_LENGTH_BYTES];
+		encodeFICH(fich, zero);
+
+		for (unsigned int id = 1U; id < 128U; id++) {
+			fich[3U] = id;
+
+			encodeFICH(fich, m_delta[id]);
+
+			for (unsigned int i = 0U; i < YSF_FICH_LENGTH_BYTES; i++)
+				m_delta[id][i] ^= zero[i];
+		}
+	}
+};
+
+static const CFICHDGIdDeltas& getDGIdDeltas()
 {
-	m_fich = new unsigned char[6U];
+	static const CFICHDGIdDeltas deltas;
+
+	return deltas;
+}
 
+CYSFFICH::CYSFFICH(const CYSFFICH& fich) :
+m_fich(),
+m_exact(fich.m_exact)
+{
 	::memcpy(m_fich, fich.m_fich, 6U);
 }
 
 CYSFFICH::CYSFFICH() :
-	m_fich(nullptr)
+m_fich(),
+m_exact(false)
 {
-	m_fich = new unsigned char[6U];
-
-	memset(m_fich, 0x00U, 6U);
 }
 
 CYSFFICH::~CYSFFICH()
 {
-	delete[] m_fich;
 }
 
 bool CYSFFICH::decode(const unsigned char* bytes)
@@ -82,19 +144,29 @@ bool CYSFFICH::decode(const unsigned char* bytes)
 	// Skip the sync bytes
 	bytes += YSF_SYNC_LENGTH_BYTES;
 
+	// FNV-1a
+	uint32_t hash = 2166136261U;
+	for (unsigned int i = 0U; i < YSF_FICH_LENGTH_BYTES; i++)
+		hash = (hash ^ bytes[i]) * 16777619U;
+
+	for (unsigned int i = 0U; i < FICH_CACHE_SIZE; i++) {
+		const CFICHCacheEntry& entry = FICH_CACHE[i];
+		if (entry.m_used && entry.m_hash == hash && ::memcmp(entry.m_raw, bytes, YSF_FICH_LENGTH_BYTES) == 0) {
+			::memcpy(m_fich, entry.m_fich, 6U);
+			m_exact = entry.m_exact;
+			return entry.m_valid;
+		}
+	}
+
 	CYSFConvolution viterbi;
 	viterbi.start();
 
 	// Deinterleave the FICH and send bits to the Viterbi decoder
-	for (unsigned int i = 0U; i < 100U; i++) {
-		unsigned int n = INTERLEAVE_TABLE[i];
-		uint8_t s0 = READ_BIT1(bytes, n) ? 1U : 0U;
+	unsigned char dibits[100U];
+	INTERLEAVER.deinterleave(bytes, dibits);
 
-		n++;
-		uint8_t s1 = READ_BIT1(bytes, n) ? 1U : 0U;
-
-		viterbi.decode(s0, s1);
-	}
+	for (unsigned int i = 0U; i < 100U; i++)
+		viterbi.decode(dibits[i] >> 1, dibits[i] & 0x01U);
 
 	unsigned char output[13U];
 	viterbi.chainback(output, 96U);
@@ -111,67 +183,52 @@ bool CYSFFICH::decode(const unsigned char* bytes)
 	m_fich[4U] = ((b2 << 4) & 0xF0U) | ((b3 >> 8) & 0x0FU);
 	m_fich[5U] = (b3 >> 0) & 0xFFU;
 
-	return CCRC::checkCCITT16(m_fich, 6U);
-}
+	bool valid = CCRC::checkCCITT16(m_fich, 6U);
 
-void CYSFFICH::encode(unsigned char* bytes)
-{
-	assert(bytes != nullptr);
-
-	// Skip the sync bytes
-	bytes += YSF_SYNC_LENGTH_BYTES;
-
-	CCRC::addCCITT16(m_fich, 6U);
+	// The block is exact only if it is the encoding of the FICH that it
+	// decoded to. A zero Viterbi metric does not show that, as the decoder
+	// starts from every state at once and so ignores some early errors.
+	m_exact = false;
+	if (valid) {
+		unsigned char fich[6U];
+		::memcpy(fich, m_fich, 6U);
 
-	unsigned int b0 = ((m_fich[0U] << 4) & 0xFF0U) | ((m_fich[1U] >> 4) & 0x00FU);
-	unsigned int b1 = ((m_fich[1U] << 8) & 0xF00U) | ((m_fich[2U] >> 0) & 0x0FFU);
-	unsigned int b2 = ((m_fich[3U] << 4) & 0xFF0U) | ((m_fich[4U] >> 4) & 0x00FU);
-	unsigned int b3 = ((m_fich[4U] << 8) & 0xF00U) | ((m_fich[5U] >> 0) & 0x0FFU);
+		unsigned char encoded[YSF_FICH_LENGTH_BYTES];
+		encodeFICH(fich, encoded);
 
-	unsigned int c0 = CGolay24128::encode24128(b0);
-	unsigned int c1 = CGolay24128::encode24128(b1);
-	unsigned int c2 = CGolay24128::encode24128(b2);
-	unsigned int c3 = CGolay24128::encode24128(b3);
+		m_exact = ::memcmp(encoded, bytes, YSF_FICH_LENGTH_BYTES) == 0;
+	}
 
-	unsigned char conv[13U];
-	conv[0U]  = (c0 >> 16) & 0xFFU;
-	conv[1U]  = (c0 >> 8) & 0xFFU;
-	conv[2U]  = (c0 >> 0) & 0xFFU;
-	conv[3U]  = (c1 >> 16) & 0xFFU;
-	conv[4U]  = (c1 >> 8) & 0xFFU;
-	conv[5U]  = (c1 >> 0) & 0xFFU;
-	conv[6U]  = (c2 >> 16) & 0xFFU;
-	conv[7U]  = (c2 >> 8) & 0xFFU;
-	conv[8U]  = (c2 >> 0) & 0xFFU;
-	conv[9U]  = (c3 >> 16) & 0xFFU;
-	conv[10U] = (c3 >> 8) & 0xFFU;
-	conv[11U] = (c3 >> 0) & 0xFFU;
-	conv[12U] = 0x00U;
+	CFICHCacheEntry& entry = FICH_CACHE[FICH_CACHE_NEXT];
+	FICH_CACHE_NEXT = (FICH_CACHE_NEXT + 1U) % FICH_CACHE_SIZE;
 
-	CYSFConvolution convolution;
-	unsigned char convolved[25U];
-	convolution.encode(conv, convolved, 100U);
+	entry.m_hash  = hash;
+	::memcpy(entry.m_raw, bytes, YSF_FICH_LENGTH_BYTES);
+	::memcpy(entry.m_fich, m_fich, 6U);
+	entry.m_valid = valid;
+	entry.m_exact = m_exact;
+	entry.m_used  = true;
 
-	unsigned int j = 0U;
-	for (unsigned int i = 0U; i < 100U; i++) {
-		unsigned int n = INTERLEAVE_TABLE[i];
+	return valid;
+}
 
-		bool s0 = READ_BIT1(convolved, j) != 0U;
-		j++;
+void CYSFFICH::encode(unsigned char* bytes)
+{
+	assert(bytes != nullptr);
 
-		bool s1 = READ_BIT1(convolved, j) != 0U;
-		j++;
+	// Skip the sync bytes
+	bytes += YSF_SYNC_LENGTH_BYTES;
 
-		WRITE_BIT1(bytes, n, s0);
+	encodeFICH(m_fich, bytes);
 
-		n++;
-		WRITE_BIT1(bytes, n, s1);
-	}
+	m_exact = true;
 }
 
 void CYSFFICH::setRaw(const unsigned char* bytes)
 {
 	::memcpy(m_fich, bytes, 4U);
+
+	m_exact = false;
 }
 
 void CYSFFICH::getRaw(unsigned char* bytes) const
@@ -233,36 +290,48 @@ void CYSFFICH::setFI(unsigned char fi)
 {
 	m_fich[0U] &= 0x3FU;
 	m_fich[0U] |= (fi << 6) & 0xC0U;
+
+	m_exact = false;
 }
 
 void CYSFFICH::setBN(unsigned char bn)
 {
 	m_fich[0U] &= 0xFCU;
 	m_fich[0U] |= bn & 0x03U;
+
+	m_exact = false;
 }
 
 void CYSFFICH::setBT(unsigned char bt)
 {
 	m_fich[1U] &= 0x3FU;
 	m_fich[1U] |= (bt << 6) & 0xC0U;
+
+	m_exact = false;
 }
 
 void CYSFFICH::setFN(unsigned char fn)
 {
 	m_fich[1U] &= 0xC7U;
 	m_fich[1U] |= (fn << 3) & 0x38U;
+
+	m_exact = false;
 }
 
 void CYSFFICH::setFT(unsigned char ft)
 {
 	m_fich[1U] &= 0xF8U;
 	m_fich[1U] |= ft & 0x07U;
+
+	m_exact = false;
 }
 
 void CYSFFICH::setMR(unsigned char mr)
 {
 	m_fich[2U] &= 0xC7U;
 	m_fich[2U] |= (mr << 3) & 0x38U;
+
+	m_exact = false;
 }
 
 void CYSFFICH::setVoIP(bool on)
@@ -271,6 +340,8 @@ void CYSFFICH::setVoIP(bool on)
 		m_fich[2U] |= 0x04U;
 	else
 		m_fich[2U] &= 0xFBU;
+
+	m_exact = false;
 }
 
 void CYSFFICH::setDev(bool on)
@@ -279,18 +350,49 @@ void CYSFFICH::setDev(bool on)
 		m_fich[2U] |= 0x40U;
 	else
 		m_fich[2U] &= 0xBFU;
+
+	m_exact = false;
 }
 
 void CYSFFICH::setDGId(unsigned char id)
 {
 	m_fich[3U] &= 0x80U;
 	m_fich[3U] |= id & 0x7FU;
+
+	m_exact = false;
+}
+
+void CYSFFICH::setDGId(unsigned char id, unsigned char* bytes)
+{
+	assert(bytes != nullptr);
+
+	// A block with errors in it is encoded afresh, so that they are not passed on
+	if (!m_exact) {
+		setDGId(id);
+		encode(bytes);
+		return;
+	}
+
+	const unsigned char* delta = getDGIdDeltas().m_delta[(m_fich[3U] ^ id) & 0x7FU];
+
+	setDGId(id);
+	CCRC::addCCITT16(m_fich, 6U);
+
+	// Skip the sync bytes
+	bytes += YSF_SYNC_LENGTH_BYTES;
+
+	for (unsigned int i = 0U; i < YSF_FICH_LENGTH_BYTES; i++)
+		bytes[i] ^= delta[i];
+
+	m_exact = true;
 }
 
 CYSFFICH& CYSFFICH::operator=(const CYSFFICH& fich)
 {
-	if (&fich != this)
+	if (&fich != this) {
 		::memcpy(m_fich, fich.m_fich, 6U);
+		m_exact = fich.m_exact;
+	}
 
 	return *this;
 }
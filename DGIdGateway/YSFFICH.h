@@ -30,7 +30,7 @@ public:
 	void encode(unsigned char* bytes);
 
 	void setRaw(const unsigned char* bytes);
-	
+
 	void getRaw(unsigned char* bytes) const;
 
 	unsigned char getFI() const;
@@ -54,10 +54,15 @@ public:
 	void setDev(bool set);
 	void setDGId(unsigned char id);
 
+	// Sets the DG-ID and changes the FICH in bytes to match, bytes must hold
+	// the FICH last decoded into or encoded from this one
+	void setDGId(unsigned char id, unsigned char* bytes);
+
 	CYSFFICH& operator=(const CYSFFICH& fich);
 
 private:
-	unsigned char* m_fich;
+	unsigned char m_fich[6U];
+	bool          m_exact;
 };
 
 #endif
@@ -0,0 +1,67 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(YSFFrameView_H)
+#define	YSFFrameView_H
+
+#include "YSFPayload.h"
+#include "YSFFICH.h"
+
+// A received network frame, which is decoded only as far as its users ask,
+// and each part at most once. The FICH and the DCH sections are decoded on
+// first use and the results are kept for anyone else looking at the same
+// frame. The V/D mode 1 data and the data FR mode data 1 are the same bits,
+// so they share one decode.
+class CYSFFrameView {
+public:
+	CYSFFrameView(const unsigned char* buffer);
+	~CYSFFrameView();
+
+	const unsigned char* getBuffer() const;
+	const unsigned char* getSource() const;
+	const unsigned char* getData() const;
+
+	bool decodeFICH();
+
+	const CYSFFICH& getFICH() const;
+
+	bool readVDMode1Data(unsigned char* dt);
+	bool readVDMode2Data(unsigned char* dt);
+
+	bool readDataFRModeData1(unsigned char* dt);
+	bool readDataFRModeData2(unsigned char* dt);
+
+private:
+	enum DCH_SECTION {
+		DCH_DATA1,
+		DCH_DATA2,
+		DCH_VD2,
+		DCH_COUNT
+	};
+
+	const unsigned char* m_buffer;
+	CYSFPayload          m_payload;
+	CYSFFICH             m_fich;
+	bool                 m_fichDecoded;
+	bool                 m_fichValid;
+	unsigned char        m_dch[DCH_COUNT][20U];
+	bool                 m_dchDecoded[DCH_COUNT];
+	bool                 m_dchValid[DCH_COUNT];
+};
+
+#endif
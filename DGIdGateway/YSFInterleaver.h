@@ -0,0 +1,85 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(YSFInterleaver_H)
+#define	YSFInterleaver_H
+
+#include <cstdint>
+
+// The YSF interleavers write the coded dibits a row at a time into a block of
+// COLUMNS by ROWS and send them a column at a time. That is turned into a pair
+// of byte permutations at compile time, so that at run time the dibits are
+// split out one per byte and then gathered into place with no per-bit
+// shifting and masking.
+template <unsigned int COLUMNS, unsigned int ROWS>
+class CYSFInterleaver {
+	static const unsigned int N = COLUMNS * ROWS;
+
+	static_assert((N % 4U) == 0U, "The dibits must fill whole bytes");
+	static_assert(N <= 256U, "The dibit positions must fit in a byte");
+
+public:
+	constexpr CYSFInterleaver() :
+	m_deinterleave(),
+	m_interleave()
+	{
+		for (unsigned int i = 0U; i < N; i++) {
+			unsigned int pos = (i % COLUMNS) * ROWS + i / COLUMNS;
+			m_deinterleave[i] = uint8_t(pos);
+			m_interleave[pos] = uint8_t(i);
+		}
+	}
+
+	// From N / 4 interleaved bytes to N dibits, one per byte, in coded order
+	void deinterleave(const unsigned char* in, unsigned char* out) const
+	{
+		unsigned char dibits[N];
+		split(in, dibits);
+
+		for (unsigned int i = 0U; i < N; i++)
+			out[i] = dibits[m_deinterleave[i]];
+	}
+
+	// From 2N coded bits to N / 4 interleaved bytes
+	void interleave(const unsigned char* in, unsigned char* out) const
+	{
+		unsigned char dibits[N];
+		split(in, dibits);
+
+		for (unsigned int i = 0U; i < (N / 4U); i++) {
+			const uint8_t* p = m_interleave + i * 4U;
+			out[i] = (dibits[p[0U]] << 6) | (dibits[p[1U]] << 4) | (dibits[p[2U]] << 2) | dibits[p[3U]];
+		}
+	}
+
+private:
+	uint8_t m_deinterleave[N];
+	uint8_t m_interleave[N];
+
+	static void split(const unsigned char* in, unsigned char* out)
+	{
+		for (unsigned int i = 0U; i < (N / 4U); i++) {
+			out[i * 4U + 0U] = (in[i] >> 6) & 0x03U;
+			out[i * 4U + 1U] = (in[i] >> 4) & 0x03U;
+			out[i * 4U + 2U] = (in[i] >> 2) & 0x03U;
+			out[i * 4U + 3U] = (in[i] >> 0) & 0x03U;
+		}
+	}
+};
+
+#endif
@@ -29,6 +29,7 @@ const unsigned int BUFFER_LENGTH = 200U;
 
 CYSFNetwork::CYSFNetwork(const std::string& localAddress, unsigned short localPort, const std::string& name, const sockaddr_storage& addr, unsigned int addrLen, const std::string& callsign, bool debug) :
 m_socket(localAddress, localPort),
+m_shared(nullptr),
 m_debug(debug),
 m_reflector(),
 m_static(true),
@@ -73,8 +74,9 @@ m_ipV6(false)
 	}
 }
 
-CYSFNetwork::CYSFNetwork(unsigned short localPort, const std::string& name, const sockaddr_storage& addr, unsigned int addrLen, const std::string& callsign, bool statc, bool debug) :
+CYSFNetwork::CYSFNetwork(unsigned short localPort, const std::string& name, const sockaddr_storage& addr, unsigned int addrLen, const std::string& callsign, CYSFSharedSocket* shared, bool statc, bool debug) :
 m_socket(localPort),
+m_shared(shared),
 m_debug(debug),
 m_reflector(),
 m_static(statc),
@@ -119,8 +121,9 @@ m_ipV6(false)
 	}
 }
 
-CYSFNetwork::CYSFNetwork(unsigned short localPort, const CYSFReflector& reflector, const std::string& callsign, bool statc, bool debug) :
+CYSFNetwork::CYSFNetwork(unsigned short localPort, const CYSFReflector& reflector, const std::string& callsign, CYSFSharedSocket* shared, bool statc, bool debug) :
 m_socket(localPort),
+m_shared(shared),
 m_debug(debug),
 m_reflector(reflector),
 m_static(statc),
@@ -171,6 +174,18 @@ bool CYSFNetwork::open()
 		return false;
 	}
 
+	// A back-end on the shared socket needs no socket of its own, unless
+	// it can't be told apart from the others there
+	if (m_shared != nullptr) {
+		if (m_reflector.hasIPv4() && m_shared->add(m_reflector.IPv4.m_addr, this)) {
+			m_ipV6  = false;
+			m_state = DGID_STATUS::NOTLINKED;
+			return true;
+		}
+
+		m_shared = nullptr;
+	}
+
 	LogMessage("Opening YSF network connection");
 
 	bool ret = false;
@@ -207,10 +222,7 @@ void CYSFNetwork::write(unsigned int dgid, const unsigned char* data)
 	if (m_debug)
 		CUtils::dump(1U, "YSF Network Data Sent", data, 155U);
 
-	if (m_ipV6)
-		m_socket.write(data, 155U, m_reflector.IPv6.m_addr, m_reflector.IPv6.m_addrLen);
-	else
-		m_socket.write(data, 155U, m_reflector.IPv4.m_addr, m_reflector.IPv4.m_addrLen);
+	writeSocket(data, 155U);
 }
 
 void CYSFNetwork::link()
@@ -234,10 +246,17 @@ void CYSFNetwork::writePoll()
 	if (m_debug)
 		CUtils::dump(1U, "YSF Network Data Sent", m_poll, 14U);
 
-	if (m_ipV6)
-		m_socket.write(m_poll, 14U, m_reflector.IPv6.m_addr, m_reflector.IPv6.m_addrLen);
+	writeSocket(m_poll, 14U);
+}
+
+void CYSFNetwork::writeSocket(const unsigned char* data, unsigned int length)
+{
+	if (m_shared != nullptr)
+		m_shared->write(data, length, m_reflector.IPv4.m_addr, m_reflector.IPv4.m_addrLen);
+	else if (m_ipV6)
+		m_socket.write(data, length, m_reflector.IPv6.m_addr, m_reflector.IPv6.m_addrLen);
 	else
-		m_socket.write(m_poll, 14U, m_reflector.IPv4.m_addr, m_reflector.IPv4.m_addrLen);
+		m_socket.write(data, length, m_reflector.IPv4.m_addr, m_reflector.IPv4.m_addrLen);
 }
 
 void CYSFNetwork::unlink()
@@ -251,10 +270,7 @@ void CYSFNetwork::unlink()
 	if (m_debug)
 		CUtils::dump(1U, "YSF Network Data Sent", m_unlink, 14U);
 
-	if (m_ipV6)
-		m_socket.write(m_unlink, 14U, m_reflector.IPv6.m_addr, m_reflector.IPv6.m_addrLen);
-	else
-		m_socket.write(m_unlink, 14U, m_reflector.IPv4.m_addr, m_reflector.IPv4.m_addrLen);
+	writeSocket(m_unlink, 14U);
 
 	LogMessage("Unlinked from %s", m_reflector.m_name.c_str());
 
@@ -284,6 +300,12 @@ void CYSFNetwork::clock(unsigned int ms)
 		writePoll();
 		m_sendPollTimer.start();
 	}
+}
+
+void CYSFNetwork::readSocket()
+{
+	if (m_state == DGID_STATUS::NOTOPEN)
+		return;
 
 	unsigned char buffer[BUFFER_LENGTH];
 	sockaddr_storage addr;
@@ -303,10 +325,17 @@ void CYSFNetwork::clock(unsigned int ms)
 			return;
 	}
 
+	receive(buffer, length);
+}
+
+void CYSFNetwork::receive(const unsigned char* data, unsigned int length)
+{
+	assert(data != nullptr);
+
 	if (m_debug)
-		CUtils::dump(1U, "YSF Network Data Received", buffer, length);
+		CUtils::dump(1U, "YSF Network Data Received", data, length);
 
-	if (::memcmp(buffer, "YSFP", 4U) == 0) {
+	if (::memcmp(data, "YSFP", 4U) == 0) {
 		m_recvPollTimer.start();
 
 		if (m_state == DGID_STATUS::LINKING) {
@@ -319,13 +348,13 @@ void CYSFNetwork::clock(unsigned int ms)
 		}
 	}
 
-	if (::memcmp(buffer, "YSFD", 4U) == 0) {
+	if (::memcmp(data, "YSFD", 4U) == 0) {
 		m_recvPollTimer.start();
 
 		unsigned char len = length;
 		m_buffer.addData(&len, 1U);
 
-		m_buffer.addData(buffer, length);
+		m_buffer.addData(data, length);
 	}
 }
 
@@ -344,8 +373,16 @@ unsigned int CYSFNetwork::read(unsigned int dgid, unsigned char* data)
 	return len;
 }
 
+const CUDPSocket& CYSFNetwork::getSocket() const
+{
+	return m_socket;
+}
+
 void CYSFNetwork::close()
 {
+	if (m_shared != nullptr)
+		m_shared->remove(m_reflector.IPv4.m_addr);
+
 	m_socket.close();
 
 	LogMessage("Closing YSF network connection");
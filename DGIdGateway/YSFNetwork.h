@@ -20,6 +20,7 @@
 #define	YSFNetwork_H
 
 #include "DGIdNetwork.h"
+#include "YSFSharedSocket.h"
 #include "YSFReflectors.h"
 #include "YSFDefines.h"
 #include "UDPSocket.h"
@@ -32,8 +33,8 @@
 class CYSFNetwork : public CDGIdNetwork {
 public:
 	CYSFNetwork(const std::string& localAddress, unsigned short localPort, const std::string& name, const sockaddr_storage& addr, unsigned int addrLen, const std::string& callsign, bool debug);
-	CYSFNetwork(unsigned short localPort, const std::string& name, const sockaddr_storage& addr, unsigned int addrLen, const std::string& callsign, bool statc, bool debug);
-	CYSFNetwork(unsigned short localPort, const CYSFReflector& reflector, const std::string& callsign, bool statc, bool debug);
+	CYSFNetwork(unsigned short localPort, const std::string& name, const sockaddr_storage& addr, unsigned int addrLen, const std::string& callsign, CYSFSharedSocket* shared, bool statc, bool debug);
+	CYSFNetwork(unsigned short localPort, const CYSFReflector& reflector, const std::string& callsign, CYSFSharedSocket* shared, bool statc, bool debug);
 	virtual ~CYSFNetwork();
 
 	virtual std::string getDesc(unsigned int dgId);
@@ -52,12 +53,20 @@ public:
 
 	virtual void clock(unsigned int ms);
 
+	virtual void readSocket();
+
+	virtual const CUDPSocket& getSocket() const;
+
+	// What has come in from the far end, by way of the shared socket
+	void receive(const unsigned char* data, unsigned int length);
+
 	virtual void unlink();
 
 	virtual void close();
 
 private:
 	CUDPSocket                 m_socket;
+	CYSFSharedSocket*          m_shared;
 	bool                       m_debug;
 	CYSFReflector              m_reflector;
 	bool                       m_static;
@@ -70,6 +79,7 @@ private:
 	bool                       m_ipV6;
 
 	void writePoll();
+	void writeSocket(const unsigned char* data, unsigned int length);
 };
 
 #endif
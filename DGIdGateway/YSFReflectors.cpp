@@ -29,8 +29,9 @@
 #include <cstring>
 #include <cctype>
 
-CYSFReflectors::CYSFReflectors(const std::string& hostsFile) :
+CYSFReflectors::CYSFReflectors(const std::string& hostsFile, CDNSResolver& resolver) :
 m_hostsFile(hostsFile),
+m_resolver(resolver),
 m_reflectors()
 {
 }
@@ -69,56 +70,75 @@ bool CYSFReflectors::load()
 
 			unsigned short port = it["port"];
 
-			sockaddr_storage addr_v4 = sockaddr_storage();
-			unsigned int     addrLen_v4 = 0U;
+			CYSFReflector* refl = new CYSFReflector;
+			refl->m_id           = id;
+			refl->m_name         = fullName;
+
+			refl->m_name.resize(16U, ' ');
+
+			m_reflectors.push_back(refl);
 
 			bool isNull = it["ipv4"].is_null();
 			if (!isNull) {
 				std::string ipv4 = it["ipv4"];
-				if (!CUDPSocket::lookup(ipv4, port, addr_v4, addrLen_v4) == 0) {
-					LogWarning("Unable to resolve the address of %s", ipv4.c_str());
-					addrLen_v4 = 0U;
-				}
+				resolve(refl, ipv4, port, AF_INET);
 			}
 
-			sockaddr_storage addr_v6 = sockaddr_storage();
-			unsigned int     addrLen_v6 = 0U;
-
 			isNull = it["ipv6"].is_null();
 			if (!isNull) {
 				std::string ipv6 = it["ipv6"];
-				if (!CUDPSocket::lookup(ipv6, port, addr_v6, addrLen_v6) == 0) {
-					LogWarning("Unable to resolve the address of %s", ipv6.c_str());
-					addrLen_v6 = 0U;
-				}
-			}
-
-			if ((addrLen_v4 > 0U) || (addrLen_v6 > 0U)) {
-				CYSFReflector* refl = new CYSFReflector;
-				refl->m_id           = id;
-				refl->m_name         = fullName;
-
-				refl->m_name.resize(16U, ' ');
-
-				refl->IPv4.m_addr    = addr_v4;
-				refl->IPv4.m_addrLen = addrLen_v4;
-				refl->IPv6.m_addr    = addr_v6;
-				refl->IPv6.m_addrLen = addrLen_v6;
-				m_reflectors.push_back(refl);
+				resolve(refl, ipv6, port, AF_INET6);
 			}
 		}
 	}
 	catch (...) {
+		// Let the queued lookups finish before their reflectors go
+		m_resolver.wait();
+		remove();
+
 		LogError("Unable to load/parse JSON file %s", m_hostsFile.c_str());
 		return false;
 	}
 
+	// The lookups all run side by side, so this only waits for the slowest
+	m_resolver.wait();
+
+	std::vector<CYSFReflector*> reflectors;
+	for (const auto& it : m_reflectors) {
+		if (it->hasIPv4() || it->hasIPv6())
+			reflectors.push_back(it);
+		else
+			delete it;
+	}
+
+	m_reflectors = reflectors;
+
 	size_t size = m_reflectors.size();
 	LogInfo("Loaded %u YSF reflectors", size);
 
 	return true;
 }
 
+void CYSFReflectors::resolve(CYSFReflector* refl, const std::string& hostname, unsigned short port, int family)
+{
+	assert(refl != nullptr);
+
+	m_resolver.lookup(hostname, port, [refl, hostname, family](bool found, const sockaddr_storage& addr, unsigned int addrLen) {
+		if (!found) {
+			LogWarning("Unable to resolve the address of %s", hostname.c_str());
+			return;
+		}
+
+		if (family == AF_INET) {
+			refl->IPv4.m_addr    = addr;
+			refl->IPv4.m_addrLen = addrLen;
+		} else {
+			refl->IPv6.m_addr    = addr;
+			refl->IPv6.m_addrLen = addrLen;
+		}
+	});
+}
+
 CYSFReflector* CYSFReflectors::findById(const std::string& id)
 {
 	for (const auto& it : m_reflectors) {
@@ -19,6 +19,7 @@
 #if !defined(YSFReflectors_H)
 #define	YSFReflectors_H
 
+#include "DNSResolver.h"
 #include "UDPSocket.h"
 
 #include <vector>
@@ -103,7 +104,7 @@ public:
 
 class CYSFReflectors {
 public:
-	CYSFReflectors(const std::string& hostsFile);
+	CYSFReflectors(const std::string& hostsFile, CDNSResolver& resolver);
 	~CYSFReflectors();
 
 	bool load();
@@ -113,8 +114,11 @@ public:
 
 private:
 	std::string                 m_hostsFile;
+	CDNSResolver&               m_resolver;
 	std::vector<CYSFReflector*> m_reflectors;
 
+	void resolve(CYSFReflector* refl, const std::string& hostname, unsigned short port, int family);
+
 	void remove();
 };
 
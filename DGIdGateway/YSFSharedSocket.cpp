@@ -0,0 +1,106 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "YSFSharedSocket.h"
+#include "YSFNetwork.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstring>
+
+const unsigned int BUFFER_LENGTH = 200U;
+
+CYSFSharedSocket::CYSFSharedSocket(unsigned short port) :
+m_socket(port),
+m_networks()
+{
+	assert(port > 0U);
+}
+
+CYSFSharedSocket::~CYSFSharedSocket()
+{
+}
+
+bool CYSFSharedSocket::open()
+{
+	LogMessage("Opening the shared YSF network connection");
+
+	// Only IPv4 far ends are shared
+	sockaddr_storage addr;
+	::memset(&addr, 0x00U, sizeof(sockaddr_storage));
+	addr.ss_family = AF_INET;
+
+	return m_socket.open(addr);
+}
+
+bool CYSFSharedSocket::add(const sockaddr_storage& addr, CYSFNetwork* network)
+{
+	assert(network != nullptr);
+
+	if (!m_socket.isOpen() || addr.ss_family != AF_INET)
+		return false;
+
+	// The far end has to be unique, or there is no telling the back-ends apart
+	return m_networks.emplace(addr, network).second;
+}
+
+void CYSFSharedSocket::remove(const sockaddr_storage& addr)
+{
+	m_networks.erase(addr);
+}
+
+bool CYSFSharedSocket::write(const unsigned char* data, unsigned int length, const sockaddr_storage& addr, unsigned int addrLen)
+{
+	assert(data != nullptr);
+
+	return m_socket.write(data, length, addr, addrLen);
+}
+
+void CYSFSharedSocket::readSocket()
+{
+	unsigned char buffers[UDP_BATCH_SIZE][BUFFER_LENGTH];
+	UDPDatagram datagrams[UDP_BATCH_SIZE];
+
+	for (unsigned int i = 0U; i < UDP_BATCH_SIZE; i++) {
+		datagrams[i].m_buffer = buffers[i];
+		datagrams[i].m_length = BUFFER_LENGTH;
+	}
+
+	int n = m_socket.read(datagrams, UDP_BATCH_SIZE);
+
+	for (int i = 0; i < n; i++) {
+		if (datagrams[i].m_addrLen == 0U)
+			continue;
+
+		auto it = m_networks.find(datagrams[i].m_addr);
+		if (it != m_networks.end())
+			it->second->receive(datagrams[i].m_buffer, datagrams[i].m_length);
+	}
+}
+
+const CUDPSocket& CYSFSharedSocket::getSocket() const
+{
+	return m_socket;
+}
+
+void CYSFSharedSocket::close()
+{
+	m_socket.close();
+
+	LogMessage("Closing the shared YSF network connection");
+}
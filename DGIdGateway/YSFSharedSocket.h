@@ -0,0 +1,54 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	YSFSharedSocket_H
+#define	YSFSharedSocket_H
+
+#include "UDPSocket.h"
+
+#include <unordered_map>
+
+class CYSFNetwork;
+
+// One local UDP port for all of the YSF type back-ends. Each back-end is
+// added under the address of its far end, and what comes in is handed to
+// the back-end that it came from.
+class CYSFSharedSocket {
+public:
+	CYSFSharedSocket(unsigned short port);
+	~CYSFSharedSocket();
+
+	bool open();
+
+	bool add(const sockaddr_storage& addr, CYSFNetwork* network);
+	void remove(const sockaddr_storage& addr);
+
+	bool write(const unsigned char* data, unsigned int length, const sockaddr_storage& addr, unsigned int addrLen);
+
+	void readSocket();
+
+	const CUDPSocket& getSocket() const;
+
+	void close();
+
+private:
+	CUDPSocket m_socket;
+	std::unordered_map<sockaddr_storage, CYSFNetwork*, CUDPAddressHash, CUDPAddressEqual> m_networks;
+};
+
+#endif
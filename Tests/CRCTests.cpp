@@ -0,0 +1,164 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "CRC.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+const unsigned int MAX_LENGTH = 1100U;
+
+// The original byte at a time CRC-CCITT16
+class CReferenceCRC {
+public:
+	CReferenceCRC() :
+	m_table()
+	{
+		for (unsigned int i = 0U; i < 256U; i++) {
+			uint16_t crc = uint16_t(i << 8);
+			for (unsigned int j = 0U; j < 8U; j++)
+				crc = (crc & 0x8000U) != 0U ? uint16_t((crc << 1) ^ 0x1021U) : uint16_t(crc << 1);
+
+			m_table[i] = crc;
+		}
+	}
+
+	void addCCITT16(unsigned char* in, unsigned int length) const
+	{
+		uint16_t crc16 = 0U;
+
+		for (unsigned int i = 0U; i < (length - 2U); i++)
+			crc16 = uint16_t(crc16 << 8) ^ m_table[(crc16 >> 8) ^ in[i]];
+
+		crc16 = ~crc16;
+
+		in[length - 2U] = crc16 >> 8;
+		in[length - 1U] = crc16 & 0xFFU;
+	}
+
+private:
+	uint16_t m_table[256U];
+};
+
+static std::mt19937 generator(0x43524331U);
+
+static void randomBytes(unsigned char* data, unsigned int length)
+{
+	for (unsigned int i = 0U; i < length; i++)
+		data[i] = uint8_t(generator());
+}
+
+// Every length from the shortest up to past a Wires-X buffer, so that each
+// mix of eight, four and single byte steps is covered
+static bool testCCITT16()
+{
+	CReferenceCRC reference;
+
+	for (unsigned int n = 0U; n < 20U; n++) {
+		for (unsigned int length = 3U; length <= MAX_LENGTH; length++) {
+			unsigned char data1[MAX_LENGTH];
+			randomBytes(data1, length);
+
+			unsigned char data2[MAX_LENGTH];
+			::memcpy(data2, data1, length);
+
+			CCRC::addCCITT16(data1, length);
+			reference.addCCITT16(data2, length);
+
+			if (::memcmp(data1, data2, length) != 0) {
+				::fprintf(stderr, "CRC-CCITT16 differs for %u bytes\n", length);
+				return false;
+			}
+
+			if (!CCRC::checkCCITT16(data1, length)) {
+				::fprintf(stderr, "CRC-CCITT16 check of %u bytes failed\n", length);
+				return false;
+			}
+
+			// Any single bit error must be caught
+			unsigned int pos = generator() % (length * 8U);
+			data1[pos >> 3] ^= 0x80U >> (pos & 7U);
+
+			if (CCRC::checkCCITT16(data1, length)) {
+				::fprintf(stderr, "CRC-CCITT16 check of %u bytes missed bit %u\n", length, pos);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+template <class T>
+static double benchmarkCCITT16(const T& crc, unsigned char* data, unsigned int length, unsigned int nBlocks)
+{
+	unsigned int check = 0U;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int n = 0U; n < nBlocks; n++) {
+		data[0U] = uint8_t(n);
+		crc.addCCITT16(data, length);
+		check += data[length - 1U];
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	if (check == 0xFFFFFFFFU)
+		::fprintf(stderr, "Unexpected check value\n");
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / double(nBlocks);
+}
+
+static void benchmark()
+{
+	// The FICH, a V/D mode 2 DCH block, a data FR block and a Wires-X buffer
+	const unsigned int LENGTHS[] = {6U, 12U, 22U, 1024U};
+
+	CReferenceCRC reference;
+	CCRC current;
+
+	for (unsigned int length : LENGTHS) {
+		unsigned char data[MAX_LENGTH];
+		randomBytes(data, length);
+
+		unsigned int nBlocks = 50000000U / length;
+
+		double original = benchmarkCCITT16(reference, data, length, nBlocks);
+		double sliced   = benchmarkCCITT16(current,   data, length, nBlocks);
+
+		::fprintf(stdout, "CRC-CCITT16 of %u bytes: original %.1f ns, current %.1f ns, %.2fx\n", length, original, sliced, original / sliced);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && ::strcmp(argv[1], "-b") == 0) {
+		benchmark();
+		return 0;
+	}
+
+	bool ok = testCCITT16();
+
+	::fprintf(stdout, "%s\n", ok ? "All CRC tests passed" : "CRC tests FAILED");
+
+	return ok ? 0 : 1;
+}
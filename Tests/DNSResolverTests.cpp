@@ -0,0 +1,74 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DNSResolver.h"
+#include "Log.h"
+
+#include <cstdio>
+
+// The size that the cache is held to in DNSResolver.cpp
+const unsigned int MAX_CACHE_ENTRIES = 5000U;
+
+const unsigned short FIRST_PORT = 10000U;
+
+// Numeric addresses resolve without any network, and each port is a cache
+// entry of its own. Once the cache is full, the answer that expires soonest,
+// the first one, makes way for the next.
+static bool testCacheLimit()
+{
+	CDNSResolver resolver(1U, 3600U);
+
+	for (unsigned int i = 0U; i <= MAX_CACHE_ENTRIES; i++) {
+		sockaddr_storage addr;
+		unsigned int addrLen;
+		if (!resolver.resolve("127.0.0.1", FIRST_PORT + i, addr, addrLen)) {
+			::fprintf(stderr, "Unable to resolve 127.0.0.1 port %u\n", FIRST_PORT + i);
+			return false;
+		}
+	}
+
+	sockaddr_storage addr;
+	unsigned int addrLen;
+
+	if (resolver.find("127.0.0.1", FIRST_PORT, addr, addrLen)) {
+		::fprintf(stderr, "The oldest answer is still cached\n");
+		return false;
+	}
+
+	for (unsigned int i = 1U; i <= MAX_CACHE_ENTRIES; i++) {
+		if (!resolver.find("127.0.0.1", FIRST_PORT + i, addr, addrLen)) {
+			::fprintf(stderr, "The answer for port %u has been dropped\n", FIRST_PORT + i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int main()
+{
+	::LogInitialise(2U, 0U);
+
+	bool ok = testCacheLimit();
+
+	::fprintf(stdout, "%s\n", ok ? "All DNSResolver tests passed" : "DNSResolver tests FAILED");
+
+	::LogFinalise();
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "OriginalTables.h"
+#include "Golay24128.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+const unsigned int GENPOL = 0x00000C75U;
+
+// The remainder of the pattern divided by the generator polynomial, worked
+// out one bit at a time as the original decoder did for every word
+static unsigned int getSyndrome(unsigned int pattern)
+{
+	for (int i = 22; i >= 11; i--) {
+		if ((pattern & (1U << i)) != 0U)
+			pattern ^= GENPOL << (i - 11);
+	}
+
+	return pattern;
+}
+
+static unsigned int countBits(unsigned int value)
+{
+	unsigned int n = 0U;
+	while (value != 0U) {
+		n += value & 1U;
+		value >>= 1;
+	}
+
+	return n;
+}
+
+// The original decoder, which divides the received word to get its syndrome
+// and looks the error pattern up in the pasted table
+class CReferenceGolay {
+public:
+	unsigned int decode23127(unsigned int code) const
+	{
+		code ^= DECODING_TABLE_23127[getSyndrome(code)];
+
+		return code >> 11;
+	}
+};
+
+static bool testEncode()
+{
+	for (unsigned int data = 0U; data < 4096U; data++) {
+		// The generated tables must match the ones that were pasted in
+		if (CGolay24128::encode23127(data) != ENCODING_TABLE_23127[data] || CGolay24128::encode24128(data) != ENCODING_TABLE_24128[data]) {
+			::fprintf(stderr, "The codeword for %03X differs from the original table\n", data);
+			return false;
+		}
+
+		// Systematic, with the data above the remainder of its division
+		unsigned int code = (data << 11) | getSyndrome(data << 11);
+
+		if (CGolay24128::encode23127(data) != (code << 1)) {
+			::fprintf(stderr, "Wrong (23,12,7) codeword for %03X\n", data);
+			return false;
+		}
+
+		// With the extra parity bit every codeword has even weight
+		unsigned int code24 = CGolay24128::encode24128(data);
+		if ((code24 >> 1) != code || (countBits(code24) & 1U) != 0U) {
+			::fprintf(stderr, "Wrong (24,12,8) codeword for %03X\n", data);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Every codeword with every error pattern of up to three bits must decode
+static bool testDecode()
+{
+	unsigned int errors[2325U];
+	unsigned int nErrors = 0U;
+	for (unsigned int pattern = 0U; pattern < (1U << 24); pattern++) {
+		if (countBits(pattern) <= 3U)
+			errors[nErrors++] = pattern;
+	}
+
+	for (unsigned int data = 0U; data < 4096U; data++) {
+		unsigned int code24 = CGolay24128::encode24128(data);
+
+		for (unsigned int i = 0U; i < nErrors; i++) {
+			unsigned int received = code24 ^ errors[i];
+
+			if (CGolay24128::decode24128(received) != data) {
+				::fprintf(stderr, "(24,12,8) decode of %03X with errors %06X failed\n", data, errors[i]);
+				return false;
+			}
+
+			unsigned char bytes[3U];
+			bytes[0U] = (received >> 16) & 0xFFU;
+			bytes[1U] = (received >> 8)  & 0xFFU;
+			bytes[2U] = (received >> 0)  & 0xFFU;
+
+			if (CGolay24128::decode24128(bytes) != data) {
+				::fprintf(stderr, "(24,12,8) byte decode of %03X with errors %06X failed\n", data, errors[i]);
+				return false;
+			}
+
+			// The (23,12,7) code leaves out the extra parity bit
+			if ((errors[i] & 0x01U) == 0U && CGolay24128::decode23127(received >> 1) != data) {
+				::fprintf(stderr, "(23,12,7) decode of %03X with errors %06X failed\n", data, errors[i] >> 1);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Every received word, including those with more than three errors, must
+// decode as it did with the original table
+static bool testDecodeOriginal()
+{
+	CReferenceGolay reference;
+
+	for (unsigned int code = 0U; code < (1U << 23); code++) {
+		if (CGolay24128::decode23127(code) != reference.decode23127(code)) {
+			::fprintf(stderr, "(23,12,7) decode of %06X differs from the original\n", code);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void benchmark()
+{
+	const unsigned int WORDS = 10000000U;
+
+	CReferenceGolay reference;
+
+	std::mt19937 generator(0x474F4C41U);
+
+	unsigned int codes[4096U];
+	for (unsigned int i = 0U; i < 4096U; i++)
+		codes[i] = generator() & 0x7FFFFFU;
+
+	unsigned int check = 0U;
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned int n = 0U; n < WORDS; n++)
+		check += reference.decode23127((codes[n % 4096U] ^ n) & 0x7FFFFFU);
+	auto middle = std::chrono::steady_clock::now();
+	for (unsigned int n = 0U; n < WORDS; n++)
+		check -= CGolay24128::decode23127((codes[n % 4096U] ^ n) & 0x7FFFFFU);
+	auto end = std::chrono::steady_clock::now();
+
+	if (check != 0U)
+		::fprintf(stderr, "The decoders disagree\n");
+
+	double original = std::chrono::duration<double, std::nano>(middle - start).count() / double(WORDS);
+	double current  = std::chrono::duration<double, std::nano>(end - middle).count() / double(WORDS);
+
+	::fprintf(stdout, "Golay (23,12,7) decode: original %.1f ns, current %.1f ns, %.2fx\n", original, current, original / current);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && ::strcmp(argv[1], "-b") == 0) {
+		benchmark();
+		return 0;
+	}
+
+	bool ok = true;
+
+	ok = testEncode()         && ok;
+	ok = testDecode()         && ok;
+	ok = testDecodeOriginal() && ok;
+
+	::fprintf(stdout, "%s\n", ok ? "All Golay24128 tests passed" : "Golay24128 tests FAILED");
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "IMRSNetwork.h"
+#include "UDPReceiver.h"
+#include "YSFDefines.h"
+#include "UDPSocket.h"
+#include "YSFFICH.h"
+#include "Log.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+const unsigned int DGID = 10U;
+
+const unsigned int N_RECEIVERS = 2U;
+const unsigned int N_DESTS     = 2U * N_RECEIVERS;
+
+// The DG-ID sent to each receiver
+const unsigned int RECEIVER_DGIDS[N_RECEIVERS] = {20U, 30U};
+
+// A header, communications frames and a terminator, as V/D mode 2
+const unsigned int N_FRAMES = 8U;
+
+static void createFrame(unsigned char* buffer, unsigned char fi, unsigned char fn)
+{
+	::memset(buffer, 0x55U, 155U);
+
+	::memcpy(buffer + 0U, "YSFDG4KLX     G4KLX     ALL       ", 34U);
+	buffer[34U] = fi == YSF_FI_TERMINATOR ? 0x01U : 0x00U;
+
+	::memcpy(buffer + 35U, YSF_SYNC_BYTES, YSF_SYNC_LENGTH_BYTES);
+
+	unsigned char raw[4U];
+	raw[0U] = fi << 6;
+	raw[1U] = (fn << 3) | 0x06U;
+	raw[2U] = YSF_DT_VD_MODE2;
+	raw[3U] = DGID;
+
+	CYSFFICH fich;
+	fich.setRaw(raw);
+	fich.encode(buffer + 35U);
+}
+
+// The IMRS destinations of a DG-ID are sent to in one batch. A destination
+// that cannot be sent to, before each good one, must not stop the good ones
+// from getting every frame.
+static bool testFanOut()
+{
+	CIMRSNetwork network;
+	if (!network.open()) {
+		::fprintf(stderr, "Unable to open the IMRS network\n");
+		return false;
+	}
+
+	sockaddr_storage local;
+	socklen_t localLen = sizeof(local);
+	if (::getsockname(network.getSocket().getFd(), (sockaddr*)&local, &localLen) < 0 || local.ss_family != AF_INET) {
+		::fprintf(stderr, "The IMRS socket is not IPv4\n");
+		return false;
+	}
+
+	CUDPReceiver receivers[N_RECEIVERS];
+
+	IMRSDest dests[N_DESTS];
+	std::vector<IMRSDest*> destinations;
+
+	for (unsigned int i = 0U; i < N_RECEIVERS; i++) {
+		if (!receivers[i].open()) {
+			::fprintf(stderr, "Unable to open a receiving socket\n");
+			return false;
+		}
+
+		IMRSDest& good = dests[i * 2U + 1U];
+		good.m_addr    = receivers[i].getAddr();
+		good.m_addrLen = receivers[i].getAddrLen();
+		good.m_dgId    = RECEIVER_DGIDS[i];
+
+		// Port zero for the first, an IPv6 address for the second
+		IMRSDest& bad = dests[i * 2U];
+		bad.m_dgId = RECEIVER_DGIDS[i];
+		if (i == 0U) {
+			bad.m_addr    = good.m_addr;
+			bad.m_addrLen = good.m_addrLen;
+			((struct sockaddr_in*)&bad.m_addr)->sin_port = 0U;
+		} else {
+			::memset(&bad.m_addr, 0x00U, sizeof(bad.m_addr));
+			struct sockaddr_in6* addr6 = (struct sockaddr_in6*)&bad.m_addr;
+			addr6->sin6_family = AF_INET6;
+			addr6->sin6_addr   = in6addr_loopback;
+			addr6->sin6_port   = ((struct sockaddr_in*)&good.m_addr)->sin_port;
+			bad.m_addrLen = sizeof(struct sockaddr_in6);
+		}
+
+		destinations.push_back(&bad);
+		destinations.push_back(&good);
+	}
+
+	network.addDGId(DGID, "Test", destinations, false);
+
+	bool ok = true;
+
+	for (unsigned int n = 0U; n < N_FRAMES && ok; n++) {
+		unsigned char fi = n == 0U ? YSF_FI_HEADER : (n == N_FRAMES - 1U ? YSF_FI_TERMINATOR : YSF_FI_COMMUNICATIONS);
+
+		unsigned char frame[155U];
+		createFrame(frame, fi, n == 0U || n == N_FRAMES - 1U ? 0U : (n - 1U) % 7U);
+
+		network.write(DGID, frame);
+
+		unsigned int expected = fi == YSF_FI_COMMUNICATIONS ? 82U : 47U;
+
+		unsigned char buffers[N_RECEIVERS][200U];
+		for (unsigned int i = 0U; i < N_RECEIVERS; i++) {
+			unsigned int len = receivers[i].read(buffers[i], 200U);
+			if (len != expected) {
+				::fprintf(stderr, "Receiver %u got %u bytes of frame %u, expected %u\n", i, len, n, expected);
+				ok = false;
+				break;
+			}
+
+			if ((buffers[i][6U] & 0x7FU) != RECEIVER_DGIDS[i]) {
+				::fprintf(stderr, "Receiver %u got DG-ID %u in frame %u\n", i, buffers[i][6U] & 0x7FU, n);
+				ok = false;
+				break;
+			}
+
+			// Apart from the DG-ID each copy is the same
+			buffers[i][6U] &= 0x80U;
+			if (i > 0U && ::memcmp(buffers[i], buffers[0U], expected) != 0) {
+				::fprintf(stderr, "The copies of frame %u differ\n", n);
+				ok = false;
+				break;
+			}
+		}
+	}
+
+	network.close();
+
+	return ok;
+}
+
+int main()
+{
+	::LogInitialise(2U, 0U);
+
+	bool ok = testFanOut();
+
+	::fprintf(stdout, "%s\n", ok ? "All IMRSNetwork tests passed" : "IMRSNetwork tests FAILED");
+
+	::LogFinalise();
+
+	return ok ? 0 : 1;
+}
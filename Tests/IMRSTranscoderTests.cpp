@@ -0,0 +1,275 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "IMRSTranscoder.h"
+#include "YSFDefines.h"
+#include "YSFPayload.h"
+#include "YSFFICH.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+// The YSF frame from the sync onwards, and its payload after the FICH
+const unsigned int YSF_DATA_LENGTH = YSF_FRAME_LENGTH_BYTES;
+const unsigned int PAYLOAD_OFFSET  = YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
+
+const unsigned int IMRS_DCH_OFFSET = 7U;
+const unsigned int IMRS_MAX_LENGTH = 107U;
+
+// Where the DCH and audio of each DT are in the two frames. The YSF payload
+// is five 18 byte blocks, and the audio takes the same bytes of each block.
+struct CTestCase {
+	const char*   m_name;
+	unsigned char m_dt;
+	unsigned char m_fn;
+	unsigned char m_ft;
+	unsigned int  m_length;
+	unsigned int  m_dchLength;
+	unsigned int  m_firstBlock;
+	unsigned int  m_audioOffset;
+	unsigned int  m_audioLength;
+	unsigned int  m_audioStart;
+};
+
+const CTestCase TEST_CASES[] = {
+	{"V/D mode 1",          YSF_DT_VD_MODE1,      3U, 6U, 72U,  20U, 0U, 9U, 9U,  27U},
+	{"V/D mode 2",          YSF_DT_VD_MODE2,      3U, 6U, 82U,  10U, 0U, 5U, 13U, 17U},
+	{"Voice FR",            YSF_DT_VOICE_FR_MODE, 3U, 6U, 107U, 0U,  0U, 0U, 18U, 17U},
+	{"Voice FR with a DCH", YSF_DT_VOICE_FR_MODE, 0U, 1U, 107U, 20U, 3U, 0U, 18U, 27U},
+	{"Data FR",             YSF_DT_DATA_FR_MODE,  3U, 6U, 107U, 0U,  0U, 0U, 18U, 17U}
+};
+
+const unsigned int N_TEST_CASES = sizeof(TEST_CASES) / sizeof(TEST_CASES[0U]);
+
+static std::mt19937 generator(0x494D5253U);
+
+static void randomBytes(unsigned char* data, unsigned int length)
+{
+	for (unsigned int i = 0U; i < length; i++)
+		data[i] = uint8_t(generator());
+}
+
+static void createFICH(const CTestCase& test, unsigned char fn, CYSFFICH& fich)
+{
+	unsigned char raw[4U];
+	raw[0U] = YSF_FI_COMMUNICATIONS << 6;
+	raw[1U] = (fn << 3) | test.m_ft;
+	raw[2U] = test.m_dt;
+	raw[3U] = 0x00U;
+
+	fich.setRaw(raw);
+}
+
+// A YSF frame with random audio, and the DCH encoded where the DT has one
+static void createFrame(const CTestCase& test, const CYSFFICH& fich, const unsigned char* dch, unsigned char* data)
+{
+	randomBytes(data, YSF_DATA_LENGTH);
+
+	::memcpy(data, YSF_SYNC_BYTES, YSF_SYNC_LENGTH_BYTES);
+
+	CYSFFICH copy(fich);
+	copy.encode(data);
+
+	CYSFPayload payload;
+
+	switch (test.m_dt) {
+	case YSF_DT_VD_MODE1:
+		payload.writeVDMode1Data(dch, data);
+		break;
+	case YSF_DT_VD_MODE2:
+		payload.writeVDMode2Data(dch, data);
+		break;
+	case YSF_DT_VOICE_FR_MODE:
+		if (test.m_dchLength > 0U) {
+			payload.writeVoiceFRModeData(dch, data);
+			::memset(data + PAYLOAD_OFFSET + 45U, 0x00U, 9U);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+// Checks the IMRS frame against the YSF frame it came from
+static bool checkIMRS(const CTestCase& test, const unsigned char* dch, const unsigned char* data, const unsigned char* frame)
+{
+	bool used[IMRS_MAX_LENGTH];
+	::memset(used, 0x00U, sizeof(used));
+
+	if (::memcmp(frame + IMRS_DCH_OFFSET, dch, test.m_dchLength) != 0) {
+		::fprintf(stderr, "%s: the IMRS DCH is wrong\n", test.m_name);
+		return false;
+	}
+
+	for (unsigned int i = 0U; i < test.m_dchLength; i++)
+		used[IMRS_DCH_OFFSET + i] = true;
+
+	for (unsigned int block = test.m_firstBlock; block < 5U; block++) {
+		unsigned int ysf  = PAYLOAD_OFFSET + block * 18U + test.m_audioOffset;
+		unsigned int imrs = test.m_audioStart + (block - test.m_firstBlock) * test.m_audioLength;
+
+		if (::memcmp(frame + imrs, data + ysf, test.m_audioLength) != 0) {
+			::fprintf(stderr, "%s: the IMRS audio of block %u is wrong\n", test.m_name, block);
+			return false;
+		}
+
+		for (unsigned int i = 0U; i < test.m_audioLength; i++)
+			used[imrs + i] = true;
+	}
+
+	for (unsigned int i = IMRS_DCH_OFFSET; i < test.m_length; i++) {
+		if (!used[i] && frame[i] != 0x00U) {
+			::fprintf(stderr, "%s: unused IMRS byte %u is not zero\n", test.m_name, i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// YSF -> IMRS -> YSF must give back the payload, and the IMRS frame must hold
+// the DCH and audio where they belong
+static bool roundTrip(CIMRSTranscoder& transcoder, const CTestCase& test, const CYSFFICH& fich, const unsigned char* dch, const unsigned char* data, const unsigned char* expected)
+{
+	unsigned char frame[IMRS_MAX_LENGTH];
+	randomBytes(frame, IMRS_MAX_LENGTH);
+
+	unsigned int length = transcoder.toIMRS(fich, data, frame);
+	if (length != test.m_length) {
+		::fprintf(stderr, "%s: IMRS frame of %u bytes, expected %u\n", test.m_name, length, test.m_length);
+		return false;
+	}
+
+	if (!checkIMRS(test, dch, expected, frame))
+		return false;
+
+	// Every byte of the payload is rewritten, so start from noise
+	unsigned char output[YSF_DATA_LENGTH];
+	randomBytes(output, YSF_DATA_LENGTH);
+	::memcpy(output, data, PAYLOAD_OFFSET);
+
+	unsigned char copy[YSF_DATA_LENGTH];
+	::memcpy(copy, output, YSF_DATA_LENGTH);
+
+	// A frame that is too short is refused and nothing is written
+	if (transcoder.fromIMRS(fich, frame, length - 1U, output)) {
+		::fprintf(stderr, "%s: a short IMRS frame was accepted\n", test.m_name);
+		return false;
+	}
+
+	if (::memcmp(output, copy, YSF_DATA_LENGTH) != 0) {
+		::fprintf(stderr, "%s: a short IMRS frame was written\n", test.m_name);
+		return false;
+	}
+
+	if (!transcoder.fromIMRS(fich, frame, length, output)) {
+		::fprintf(stderr, "%s: the IMRS frame was refused\n", test.m_name);
+		return false;
+	}
+
+	if (::memcmp(output, expected, YSF_DATA_LENGTH) != 0) {
+		::fprintf(stderr, "%s: the YSF payload did not survive the round trip\n", test.m_name);
+		return false;
+	}
+
+	return true;
+}
+
+// Each DT on its own, with a fresh transcoder and so empty DCH caches
+static bool testRoundTrip()
+{
+	for (unsigned int n = 0U; n < N_TEST_CASES; n++) {
+		const CTestCase& test = TEST_CASES[n];
+
+		for (unsigned int i = 0U; i < 1000U; i++) {
+			CYSFFICH fich;
+			createFICH(test, test.m_fn, fich);
+
+			unsigned char dch[20U];
+			randomBytes(dch, 20U);
+
+			unsigned char data[YSF_DATA_LENGTH];
+			createFrame(test, fich, dch, data);
+
+			CIMRSTranscoder transcoder;
+			if (!roundTrip(transcoder, test, fich, dch, data, data))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// All of the DTs through one transcoder, as a stream of superframes whose
+// DCH repeats for a while and then changes, so that the caches are both hit
+// and missed. Some frames have a bit error in the encoded DCH, which must be
+// corrected without the error reaching the caches.
+static bool testStream()
+{
+	CIMRSTranscoder transcoder;
+
+	unsigned char dchs[N_TEST_CASES][8U][20U];
+	for (unsigned int n = 0U; n < N_TEST_CASES; n++) {
+		for (unsigned int fn = 0U; fn < 8U; fn++)
+			randomBytes(dchs[n][fn], 20U);
+	}
+
+	for (unsigned int i = 0U; i < 20000U; i++) {
+		unsigned int n = generator() % N_TEST_CASES;
+		const CTestCase& test = TEST_CASES[n];
+
+		// Only the first voice FR frame carries a DCH
+		unsigned char fn = test.m_dchLength > 0U && test.m_dt == YSF_DT_VOICE_FR_MODE ? 0U : uint8_t(generator() % 7U);
+
+		if ((generator() % 4U) == 0U)
+			randomBytes(dchs[n][fn], 20U);
+
+		CYSFFICH fich;
+		createFICH(test, fn, fich);
+
+		unsigned char data[YSF_DATA_LENGTH];
+		createFrame(test, fich, dchs[n][fn], data);
+
+		unsigned char received[YSF_DATA_LENGTH];
+		::memcpy(received, data, YSF_DATA_LENGTH);
+
+		if (test.m_dchLength > 0U && (generator() % 5U) == 0U) {
+			// The first bytes of the payload are always encoded DCH
+			unsigned int pos = generator() % 32U;
+			received[PAYLOAD_OFFSET + (pos >> 3)] ^= 0x80U >> (pos & 7U);
+		}
+
+		if (!roundTrip(transcoder, test, fich, dchs[n][fn], received, data))
+			return false;
+	}
+
+	return true;
+}
+
+int main()
+{
+	bool ok = true;
+
+	ok = testRoundTrip() && ok;
+	ok = testStream()    && ok;
+
+	::fprintf(stdout, "%s\n", ok ? "All IMRSTranscoder tests passed" : "IMRSTranscoder tests FAILED");
+
+	return ok ? 0 : 1;
+}
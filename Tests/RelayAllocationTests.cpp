@@ -0,0 +1,369 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Relays frames between a fake MMDVM Host and a fake reflector through a
+// YSFGateway, driven one pass of its main loop at a time, and checks that
+// once running no frame causes a heap allocation.
+
+#include "UDPReceiver.h"
+#include "YSFGateway.h"
+#include "YSFDefines.h"
+#include "YSFPayload.h"
+#include "YSFFICH.h"
+#include "Log.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include <unistd.h>
+
+// The programs never call malloc() directly, so counting operator new
+// catches every heap allocation made by their code and by the library
+// containers that they use.
+static std::atomic<unsigned long> allocations(0UL);
+
+void* operator new(std::size_t size)
+{
+	allocations++;
+
+	void* p = std::malloc(size > 0U ? size : 1U);
+	if (p == nullptr)
+		throw std::bad_alloc();
+
+	return p;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	allocations++;
+
+	return std::malloc(size > 0U ? size : 1U);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+// One pass of the main loop per frame, at the YSF frame rate
+const unsigned int FRAME_TIME = 100U;
+
+const unsigned int FRAME_LENGTH = 155U;
+
+// A header, communications frames with FN running over 0 to 7, and a
+// terminator with the end of transmission bit set
+const unsigned int TX_FRAMES = 2U + 24U;
+
+static void createFrame(unsigned char* buffer, unsigned char fi, unsigned char dt, unsigned char fn, bool end)
+{
+	::memset(buffer, 0x55U, FRAME_LENGTH);
+
+	::memcpy(buffer + 0U, "YSFDG4KLX     G4KLX     ALL       ", 34U);
+	buffer[34U] = end ? 0x01U : 0x00U;
+
+	::memcpy(buffer + 35U, YSF_SYNC_BYTES, 5U);
+
+	unsigned char raw[4U];
+	raw[0U] = fi << 6;
+	raw[1U] = (fn << 3) | 0x07U;
+	raw[2U] = dt;
+	raw[3U] = 0x00U;
+
+	CYSFFICH fich;
+	fich.setRaw(raw);
+	fich.encode(buffer + 35U);
+
+	// Data FR frames carry a valid, but unknown, Wires-X command
+	if (dt == YSF_DT_DATA_FR_MODE && fi == YSF_FI_COMMUNICATIONS) {
+		unsigned char dch[20U];
+		::memset(dch, 0x20U + fn, 20U);
+
+		CYSFPayload payload;
+		payload.writeDataFRModeData1(dch, buffer + 35U);
+		payload.writeDataFRModeData2(dch, buffer + 35U);
+	}
+}
+
+static void createTransmission(unsigned char frames[][FRAME_LENGTH], unsigned char dt)
+{
+	createFrame(frames[0U], YSF_FI_HEADER, dt, 0U, false);
+
+	for (unsigned int i = 1U; i < TX_FRAMES - 1U; i++)
+		createFrame(frames[i], YSF_FI_COMMUNICATIONS, dt, (i - 1U) % 8U, false);
+
+	createFrame(frames[TX_FRAMES - 1U], YSF_FI_TERMINATOR, dt, 0U, true);
+}
+
+class CRelay {
+public:
+	CRelay() :
+	m_iniFile(createFileName("ini")),
+	m_hostsFile(createFileName("json")),
+	m_host(),
+	m_reflector(),
+	m_gateway(m_iniFile),
+	m_gatewayAddr(),
+	m_gatewayAddrLen(0U),
+	m_ysfAddr(),
+	m_ysfAddrLen(0U),
+	m_relayed(0U)
+	{
+	}
+
+	~CRelay()
+	{
+		::unlink(m_iniFile.c_str());
+		::unlink(m_hostsFile.c_str());
+	}
+
+	bool open()
+	{
+		if (!m_host.open() || !m_reflector.open())
+			return false;
+
+		if (!writeHosts() || !writeConfig())
+			return false;
+
+		if (!m_gateway.readConfig() || !m_gateway.open())
+			return false;
+
+		// The gateway is given no ports of its own, so its addresses are
+		// learnt from the polls that it sends to the host and the reflector
+		for (unsigned int i = 0U; i < 1000U && (m_gatewayAddrLen == 0U || m_ysfAddrLen == 0U); i++) {
+			m_gateway.clock(FRAME_TIME);
+
+			unsigned char buffer[200U];
+			while (receive(m_host, buffer, m_gatewayAddr, m_gatewayAddrLen) > 0U)
+				;
+			while (receive(m_reflector, buffer, m_ysfAddr, m_ysfAddrLen) > 0U)
+				;
+		}
+
+		return m_gatewayAddrLen > 0U && m_ysfAddrLen > 0U;
+	}
+
+	// Sends a frame from the host to the reflector and back again
+	bool relay(const unsigned char* frame)
+	{
+		if (!m_host.write(frame, FRAME_LENGTH, m_gatewayAddr, m_gatewayAddrLen))
+			return false;
+
+		m_gateway.clock(FRAME_TIME);
+
+		if (!wait(m_reflector, frame, m_ysfAddr, m_ysfAddrLen))
+			return false;
+
+		if (!m_reflector.write(frame, FRAME_LENGTH, m_ysfAddr, m_ysfAddrLen))
+			return false;
+
+		m_gateway.clock(FRAME_TIME);
+
+		if (!wait(m_host, frame, m_gatewayAddr, m_gatewayAddrLen))
+			return false;
+
+		m_relayed++;
+
+		return true;
+	}
+
+	void close()
+	{
+		m_gateway.close();
+	}
+
+	unsigned int getRelayed() const
+	{
+		return m_relayed;
+	}
+
+private:
+	std::string      m_iniFile;
+	std::string      m_hostsFile;
+	CUDPReceiver     m_host;
+	CUDPReceiver     m_reflector;
+	CYSFGateway      m_gateway;
+	sockaddr_storage m_gatewayAddr;
+	unsigned int     m_gatewayAddrLen;
+	sockaddr_storage m_ysfAddr;
+	unsigned int     m_ysfAddrLen;
+	unsigned int     m_relayed;
+
+	static std::string createFileName(const char* extension)
+	{
+		return "/tmp/RelayAllocationTests." + std::to_string(::getpid()) + "." + extension;
+	}
+
+	static unsigned short getPort(const CUDPReceiver& socket)
+	{
+		return ntohs(((const struct sockaddr_in*)&socket.getAddr())->sin_port);
+	}
+
+	bool writeHosts() const
+	{
+		FILE* fp = ::fopen(m_hostsFile.c_str(), "wt");
+		if (fp == nullptr)
+			return false;
+
+		::fprintf(fp, "{\"reflectors\":[{\"designator\":\"12345\",\"country\":\"GB\",\"name\":\"Test\","
+			"\"use_xx_prefix\":false,\"user_count\":\"001\",\"description\":null,\"port\":%u,"
+			"\"ipv4\":\"127.0.0.1\",\"ipv6\":null}]}\n", getPort(m_reflector));
+
+		return ::fclose(fp) == 0;
+	}
+
+	// No APRS, as its beacons are built on a timer rather than per frame
+	bool writeConfig() const
+	{
+		FILE* fp = ::fopen(m_iniFile.c_str(), "wt");
+		if (fp == nullptr)
+			return false;
+
+		::fprintf(fp, "[General]\nCallsign=G4KLX\nSuffix=RPT\nId=1234567\n");
+		::fprintf(fp, "RptAddress=127.0.0.1\nRptPort=%u\nLocalAddress=127.0.0.1\nLocalPort=0\n", getPort(m_host));
+		::fprintf(fp, "Debug=0\nDaemon=0\n\n");
+		::fprintf(fp, "[Info]\nRXFrequency=430475000\nTXFrequency=439475000\nName=Test\n\n");
+		::fprintf(fp, "[APRS]\nEnable=0\n\n");
+		::fprintf(fp, "[Network]\nStartup=GB-Test\n\n");
+		::fprintf(fp, "[YSF Network]\nEnable=1\nPort=0\nHosts=%s\n\n", m_hostsFile.c_str());
+		::fprintf(fp, "[FCS Network]\nEnable=0\n");
+
+		return ::fclose(fp) == 0;
+	}
+
+	// Reads the next datagram, answering it and noting the sender if it is a poll
+	unsigned int receive(CUDPReceiver& socket, unsigned char* buffer, sockaddr_storage& addr, unsigned int& addrLen)
+	{
+		sockaddr_storage from;
+		unsigned int fromLen;
+		unsigned int len = socket.read(buffer, 200U, from, fromLen);
+		if (len == 0U)
+			return 0U;
+
+		if (::memcmp(buffer, "YSFP", 4U) == 0) {
+			unsigned char reply[14U];
+			::memcpy(reply + 0U, "YSFPREFLECTOR ", 14U);
+			socket.write(reply, 14U, from, fromLen);
+
+			addr    = from;
+			addrLen = fromLen;
+		}
+
+		return len;
+	}
+
+	// Waits for the frame, answering any polls that arrive before it
+	bool wait(CUDPReceiver& socket, const unsigned char* frame, sockaddr_storage& addr, unsigned int& addrLen)
+	{
+		for (unsigned int i = 0U; i < 1000U; i++) {
+			unsigned char buffer[200U];
+			unsigned int len = receive(socket, buffer, addr, addrLen);
+			if (len == 0U) {
+				m_gateway.clock(FRAME_TIME);
+				continue;
+			}
+
+			if (len == FRAME_LENGTH && ::memcmp(buffer, frame, FRAME_LENGTH) == 0)
+				return true;
+		}
+
+		::fprintf(stderr, "A relayed frame did not arrive\n");
+		return false;
+	}
+};
+
+int main()
+{
+	// Messages are shown, debug output is filtered, as by default
+	::LogInitialise(2U, 0U);
+
+	// V/D mode 1 and 2 voice, voice FR, and data FR with a Wires-X command
+	const unsigned char DTS[] = {YSF_DT_VD_MODE1, YSF_DT_VD_MODE2, YSF_DT_VOICE_FR_MODE, YSF_DT_DATA_FR_MODE};
+	const unsigned int N_DTS = sizeof(DTS) / sizeof(DTS[0U]);
+
+	static unsigned char transmissions[N_DTS][TX_FRAMES][FRAME_LENGTH];
+	for (unsigned int i = 0U; i < N_DTS; i++)
+		createTransmission(transmissions[i], DTS[i]);
+
+	CRelay relay;
+	if (!relay.open()) {
+		::fprintf(stderr, "Unable to start the gateway\n");
+		return 1;
+	}
+
+	// Anything allocated on first use is done while warming up
+	for (unsigned int i = 0U; i < N_DTS; i++) {
+		for (unsigned int j = 0U; j < TX_FRAMES; j++) {
+			if (!relay.relay(transmissions[i][j]))
+				return 1;
+		}
+	}
+
+	unsigned long before = allocations;
+
+	// Long enough for the poll timers to fire several times
+	for (unsigned int n = 0U; n < 20U; n++) {
+		for (unsigned int i = 0U; i < N_DTS; i++) {
+			for (unsigned int j = 0U; j < TX_FRAMES; j++) {
+				if (!relay.relay(transmissions[i][j]))
+					return 1;
+			}
+		}
+	}
+
+	unsigned long after = allocations;
+
+	relay.close();
+
+	bool ok = after == before;
+
+	::fprintf(stdout, "Relayed %u frames, %lu heap allocations in the steady state\n", relay.getRelayed(), after - before);
+	::fprintf(stdout, "%s\n", ok ? "All relay allocation tests passed" : "Relay allocation tests FAILED");
+
+	::LogFinalise();
+
+	return ok ? 0 : 1;
+}
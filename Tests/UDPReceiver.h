@@ -0,0 +1,116 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(UDPReceiver_H)
+#define	UDPReceiver_H
+
+#include <cstring>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+// A plain socket on a loopback port chosen by the kernel, to stand in for
+// the other end of the sockets under test. CUDPSocket only binds when given
+// a port.
+class CUDPReceiver {
+public:
+	CUDPReceiver() :
+	m_fd(-1),
+	m_addr(),
+	m_addrLen(0U)
+	{
+	}
+
+	~CUDPReceiver()
+	{
+		if (m_fd >= 0)
+			::close(m_fd);
+	}
+
+	bool open()
+	{
+		m_fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+		if (m_fd < 0)
+			return false;
+
+		struct sockaddr_in* addr = (struct sockaddr_in*)&m_addr;
+		addr->sin_family      = AF_INET;
+		addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr->sin_port        = 0U;
+
+		if (::bind(m_fd, (sockaddr*)&m_addr, sizeof(struct sockaddr_in)) < 0)
+			return false;
+
+		socklen_t len = sizeof(m_addr);
+		if (::getsockname(m_fd, (sockaddr*)&m_addr, &len) < 0)
+			return false;
+
+		m_addrLen = len;
+
+		struct timeval tv;
+		tv.tv_sec  = 1;
+		tv.tv_usec = 0;
+
+		return ::setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) == 0;
+	}
+
+	// Returns the length of the next datagram, or zero if none arrives
+	unsigned int read(unsigned char* buffer, unsigned int length)
+	{
+		ssize_t len = ::recv(m_fd, buffer, length, 0);
+
+		return len > 0 ? (unsigned int)len : 0U;
+	}
+
+	// As above, with the sender, but without waiting
+	unsigned int read(unsigned char* buffer, unsigned int length, sockaddr_storage& addr, unsigned int& addrLen)
+	{
+		socklen_t len = sizeof(addr);
+		ssize_t ret = ::recvfrom(m_fd, buffer, length, MSG_DONTWAIT, (sockaddr*)&addr, &len);
+		if (ret <= 0)
+			return 0U;
+
+		addrLen = len;
+
+		return (unsigned int)ret;
+	}
+
+	bool write(const unsigned char* buffer, unsigned int length, const sockaddr_storage& addr, unsigned int addrLen)
+	{
+		return ::sendto(m_fd, buffer, length, 0, (const sockaddr*)&addr, addrLen) == ssize_t(length);
+	}
+
+	const sockaddr_storage& getAddr() const
+	{
+		return m_addr;
+	}
+
+	unsigned int getAddrLen() const
+	{
+		return m_addrLen;
+	}
+
+private:
+	int              m_fd;
+	sockaddr_storage m_addr;
+	unsigned int     m_addrLen;
+};
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "UDPReceiver.h"
+#include "UDPSocket.h"
+
+#include <cstdio>
+#include <cstring>
+
+// More than two batches, so that a failure is seen at the start of a batch,
+// in the middle of one, and as the last datagram of all
+const unsigned int N_DATAGRAMS = 40U;
+
+// A batched write must send every datagram that can be sent, whatever fails
+// before it in the batch. Every third destination is one that the IPv4
+// socket cannot send to, either port zero or an IPv6 address.
+static bool testWriteFailures()
+{
+	CUDPReceiver receiver;
+	if (!receiver.open()) {
+		::fprintf(stderr, "Unable to open the receiving socket\n");
+		return false;
+	}
+
+	CUDPSocket socket("127.0.0.1", 0U);
+	if (!socket.open()) {
+		::fprintf(stderr, "Unable to open the sending socket\n");
+		return false;
+	}
+
+	sockaddr_storage badPort = receiver.getAddr();
+	((struct sockaddr_in*)&badPort)->sin_port = 0U;
+
+	sockaddr_storage badFamily;
+	::memset(&badFamily, 0x00U, sizeof(badFamily));
+	struct sockaddr_in6* addr6 = (struct sockaddr_in6*)&badFamily;
+	addr6->sin6_family = AF_INET6;
+	addr6->sin6_addr   = in6addr_loopback;
+	addr6->sin6_port   = ((const struct sockaddr_in*)&receiver.getAddr())->sin_port;
+
+	unsigned char buffers[N_DATAGRAMS][4U];
+	UDPDatagram datagrams[N_DATAGRAMS];
+
+	unsigned int expected = 0U;
+	for (unsigned int i = 0U; i < N_DATAGRAMS; i++) {
+		::memcpy(buffers[i], &i, sizeof(i));
+
+		datagrams[i].m_buffer = buffers[i];
+		datagrams[i].m_length = 4U;
+
+		if ((i % 3U) == 0U) {
+			datagrams[i].m_addr    = (i % 2U) == 0U ? badPort : badFamily;
+			datagrams[i].m_addrLen = (i % 2U) == 0U ? sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6);
+		} else {
+			datagrams[i].m_addr    = receiver.getAddr();
+			datagrams[i].m_addrLen = receiver.getAddrLen();
+			expected++;
+		}
+	}
+
+	unsigned int sent = socket.write(datagrams, N_DATAGRAMS);
+	if (sent != expected) {
+		::fprintf(stderr, "Sent %u datagrams, expected %u\n", sent, expected);
+		return false;
+	}
+
+	// Each good datagram arrives, in order
+	for (unsigned int i = 0U; i < N_DATAGRAMS; i++) {
+		if ((i % 3U) == 0U)
+			continue;
+
+		unsigned char buffer[10U];
+		unsigned int len = receiver.read(buffer, 10U);
+		if (len != 4U || ::memcmp(buffer, buffers[i], 4U) != 0) {
+			::fprintf(stderr, "Datagram %u was not received\n", i);
+			return false;
+		}
+	}
+
+	socket.close();
+
+	return true;
+}
+
+int main()
+{
+	bool ok = testWriteFailures();
+
+	::fprintf(stdout, "%s\n", ok ? "All UDPSocket tests passed" : "UDPSocket tests FAILED");
+
+	return ok ? 0 : 1;
+}
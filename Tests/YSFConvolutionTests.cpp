@@ -0,0 +1,378 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "YSFConvolution.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
+
+#define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
+#define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
+
+// The longest run that the decoder holds decisions for
+const unsigned int MAX_STEPS = 180U;
+
+// The original bit-serial decoder, one state at a time
+class CReferenceConvolution {
+public:
+	void start()
+	{
+		::memset(m_metrics1, 0x00U, sizeof(m_metrics1));
+		::memset(m_metrics2, 0x00U, sizeof(m_metrics2));
+
+		m_oldMetrics = m_metrics1;
+		m_newMetrics = m_metrics2;
+		m_dp = m_decisions;
+	}
+
+	void decode(uint8_t s0, uint8_t s1)
+	{
+		const uint8_t BRANCH_TABLE1[] = {0U, 0U, 0U, 0U, 1U, 1U, 1U, 1U};
+		const uint8_t BRANCH_TABLE2[] = {0U, 1U, 1U, 0U, 0U, 1U, 1U, 0U};
+
+		*m_dp = 0U;
+
+		for (unsigned int i = 0U; i < 8U; i++) {
+			unsigned int j = i * 2U;
+
+			uint16_t metric = (BRANCH_TABLE1[i] ^ s0) + (BRANCH_TABLE2[i] ^ s1);
+
+			uint16_t m0 = m_oldMetrics[i] + metric;
+			uint16_t m1 = m_oldMetrics[i + 8U] + (2U - metric);
+			uint8_t decision0 = (m0 >= m1) ? 1U : 0U;
+			m_newMetrics[j + 0U] = decision0 != 0U ? m1 : m0;
+
+			m0 = m_oldMetrics[i] + (2U - metric);
+			m1 = m_oldMetrics[i + 8U] + metric;
+			uint8_t decision1 = (m0 >= m1) ? 1U : 0U;
+			m_newMetrics[j + 1U] = decision1 != 0U ? m1 : m0;
+
+			*m_dp |= (uint64_t(decision1) << (j + 1U)) | (uint64_t(decision0) << (j + 0U));
+		}
+
+		++m_dp;
+
+		uint16_t* tmp = m_oldMetrics;
+		m_oldMetrics = m_newMetrics;
+		m_newMetrics = tmp;
+	}
+
+	void chainback(unsigned char* out, unsigned int nBits)
+	{
+		uint32_t state = 0U;
+
+		while (nBits-- > 0) {
+			--m_dp;
+
+			uint32_t  i = state >> 4;
+			uint8_t bit = uint8_t(*m_dp >> i) & 1;
+			state = (bit << 7) | (state >> 1);
+
+			WRITE_BIT1(out, nBits, bit != 0U);
+		}
+	}
+
+	uint16_t getMetric() const
+	{
+		return m_oldMetrics[0U];
+	}
+
+private:
+	uint16_t  m_metrics1[16U];
+	uint16_t  m_metrics2[16U];
+	uint16_t* m_oldMetrics;
+	uint16_t* m_newMetrics;
+	uint64_t  m_decisions[MAX_STEPS];
+	uint64_t* m_dp;
+};
+
+// The original bit-serial encoder
+static void referenceEncode(const unsigned char* in, unsigned char* out, unsigned int nBits)
+{
+	uint8_t d1 = 0U, d2 = 0U, d3 = 0U, d4 = 0U;
+	uint32_t k = 0U;
+	for (unsigned int i = 0U; i < nBits; i++) {
+		uint8_t d = READ_BIT1(in, i) ? 1U : 0U;
+
+		uint8_t g1 = (d + d3 + d4) & 1;
+		uint8_t g2 = (d + d1 + d2 + d4) & 1;
+
+		d4 = d3;
+		d3 = d2;
+		d2 = d1;
+		d1 = d;
+
+		WRITE_BIT1(out, k, g1 != 0U);
+		k++;
+
+		WRITE_BIT1(out, k, g2 != 0U);
+		k++;
+	}
+}
+
+static std::mt19937 generator(0x59534647U);
+
+static void randomBytes(unsigned char* data, unsigned int length)
+{
+	for (unsigned int i = 0U; i < length; i++)
+		data[i] = uint8_t(generator());
+}
+
+// Runs both decoders over the same symbols and compares the traced path and
+// its metric. Each step of the traced path reads one decision from the
+// step's decision word, so a decision that differs along it shows up.
+static bool compareDecoders(const unsigned char* symbols, unsigned int nSteps)
+{
+	CYSFConvolution convolution;
+	CReferenceConvolution reference;
+
+	convolution.start();
+	reference.start();
+
+	for (unsigned int i = 0U; i < nSteps; i++) {
+		uint8_t s0 = READ_BIT1(symbols, i * 2U + 0U) ? 1U : 0U;
+		uint8_t s1 = READ_BIT1(symbols, i * 2U + 1U) ? 1U : 0U;
+
+		convolution.decode(s0, s1);
+		reference.decode(s0, s1);
+	}
+
+	if (convolution.getMetric() != reference.getMetric()) {
+		::fprintf(stderr, "Path metric differs after %u steps, %u != %u\n", nSteps, convolution.getMetric(), reference.getMetric());
+		return false;
+	}
+
+	unsigned char out1[MAX_STEPS / 8U + 1U];
+	unsigned char out2[MAX_STEPS / 8U + 1U];
+	::memset(out1, 0x00U, sizeof(out1));
+	::memset(out2, 0x00U, sizeof(out2));
+
+	convolution.chainback(out1, nSteps);
+	reference.chainback(out2, nSteps);
+
+	if (::memcmp(out1, out2, nSteps / 8U + 1U) != 0) {
+		::fprintf(stderr, "Decoded bits differ after %u steps\n", nSteps);
+		return false;
+	}
+
+	return true;
+}
+
+static bool testDecodeRandom()
+{
+	// Random symbols are mostly ties, which is where the paths most easily differ
+	for (unsigned int n = 0U; n < 20000U; n++) {
+		unsigned char symbols[MAX_STEPS / 4U];
+		randomBytes(symbols, sizeof(symbols));
+
+		unsigned int nSteps = 1U + generator() % MAX_STEPS;
+		if (!compareDecoders(symbols, nSteps))
+			return false;
+	}
+
+	return true;
+}
+
+static bool testDecodeNoisy()
+{
+	// Encoded data with up to one in eight symbols flipped
+	for (unsigned int n = 0U; n < 20000U; n++) {
+		unsigned char data[MAX_STEPS / 8U + 1U];
+		randomBytes(data, sizeof(data));
+
+		unsigned char symbols[MAX_STEPS / 4U + 1U];
+		::memset(symbols, 0x00U, sizeof(symbols));
+		referenceEncode(data, symbols, MAX_STEPS);
+
+		unsigned int nErrors = generator() % (MAX_STEPS / 4U);
+		for (unsigned int i = 0U; i < nErrors; i++) {
+			unsigned int pos = generator() % (MAX_STEPS * 2U);
+			symbols[pos >> 3] ^= BIT_MASK_TABLE[pos & 7U];
+		}
+
+		if (!compareDecoders(symbols, MAX_STEPS))
+			return false;
+	}
+
+	return true;
+}
+
+static bool testDecodeClean()
+{
+	// Without errors the data comes back exactly and the metric is zero
+	for (unsigned int n = 0U; n < 1000U; n++) {
+		unsigned char data[MAX_STEPS / 8U + 1U];
+		randomBytes(data, sizeof(data));
+
+		// Flush the encoder with four zero bits at the end
+		for (unsigned int i = MAX_STEPS - 4U; i < MAX_STEPS; i++)
+			WRITE_BIT1(data, i, false);
+
+		unsigned char symbols[MAX_STEPS / 4U + 1U];
+		referenceEncode(data, symbols, MAX_STEPS);
+
+		CYSFConvolution convolution;
+		convolution.start();
+		for (unsigned int i = 0U; i < MAX_STEPS; i++)
+			convolution.decode(READ_BIT1(symbols, i * 2U + 0U) ? 1U : 0U, READ_BIT1(symbols, i * 2U + 1U) ? 1U : 0U);
+
+		if (convolution.getMetric() != 0U) {
+			::fprintf(stderr, "Non-zero metric %u for an error free run\n", convolution.getMetric());
+			return false;
+		}
+
+		unsigned char out[MAX_STEPS / 8U + 1U];
+		convolution.chainback(out, MAX_STEPS - 4U);
+
+		for (unsigned int i = 0U; i < MAX_STEPS - 4U; i++) {
+			if ((READ_BIT1(out, i) != 0U) != (READ_BIT1(data, i) != 0U)) {
+				::fprintf(stderr, "Bit %u is wrong in an error free run\n", i);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool testEncode()
+{
+	// Every length up to 400 bits, over the same random fill so
+	// that any bits written past the end also show up
+	const unsigned int MAX_BITS = 400U;
+
+	for (unsigned int n = 0U; n < 100U; n++) {
+		for (unsigned int nBits = 1U; nBits <= MAX_BITS; nBits++) {
+			unsigned char data[MAX_BITS / 8U];
+			randomBytes(data, sizeof(data));
+
+			unsigned char out1[MAX_BITS / 4U + 1U];
+			randomBytes(out1, sizeof(out1));
+
+			unsigned char out2[MAX_BITS / 4U + 1U];
+			::memcpy(out2, out1, sizeof(out2));
+
+			CYSFConvolution convolution;
+			convolution.encode(data, out1, nBits);
+			referenceEncode(data, out2, nBits);
+
+			if (::memcmp(out1, out2, sizeof(out1)) != 0) {
+				::fprintf(stderr, "Encoded output differs for %u bits\n", nBits);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+template <class T>
+static double benchmarkDecode(const unsigned char* symbols, unsigned int nBlocks)
+{
+	T convolution;
+	unsigned char out[MAX_STEPS / 8U + 1U];
+	unsigned int check = 0U;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int n = 0U; n < nBlocks; n++) {
+		const unsigned char* block = symbols + (n % 16U) * (MAX_STEPS / 4U);
+
+		convolution.start();
+		for (unsigned int i = 0U; i < MAX_STEPS; i++)
+			convolution.decode(READ_BIT1(block, i * 2U + 0U) ? 1U : 0U, READ_BIT1(block, i * 2U + 1U) ? 1U : 0U);
+
+		convolution.chainback(out, MAX_STEPS - 4U);
+		check += out[0U];
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	if (check == 0xFFFFFFFFU)
+		::fprintf(stderr, "Unexpected check value\n");
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / double(nBlocks);
+}
+
+static double benchmarkEncode(bool reference, const unsigned char* data, unsigned int nBlocks)
+{
+	CYSFConvolution convolution;
+	unsigned char out[MAX_STEPS / 4U];
+	unsigned int check = 0U;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int n = 0U; n < nBlocks; n++) {
+		const unsigned char* block = data + (n % 16U) * (MAX_STEPS / 8U);
+
+		if (reference)
+			referenceEncode(block, out, MAX_STEPS);
+		else
+			convolution.encode(block, out, MAX_STEPS);
+
+		check += out[n % sizeof(out)];
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	if (check == 0xFFFFFFFFU)
+		::fprintf(stderr, "Unexpected check value\n");
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / double(nBlocks);
+}
+
+static void benchmark()
+{
+	const unsigned int BLOCKS = 200000U;
+
+	unsigned char symbols[16U * (MAX_STEPS / 4U)];
+	randomBytes(symbols, sizeof(symbols));
+
+	double reference = benchmarkDecode<CReferenceConvolution>(symbols, BLOCKS);
+	double current   = benchmarkDecode<CYSFConvolution>(symbols, BLOCKS);
+
+	::fprintf(stdout, "Viterbi decode of %u steps: reference %.0f ns, current %.0f ns, %.2fx\n", MAX_STEPS, reference, current, reference / current);
+
+	reference = benchmarkEncode(true,  symbols, BLOCKS * 10U);
+	current   = benchmarkEncode(false, symbols, BLOCKS * 10U);
+
+	::fprintf(stdout, "Convolutional encode of %u bits: reference %.0f ns, current %.0f ns, %.2fx\n", MAX_STEPS, reference, current, reference / current);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && ::strcmp(argv[1], "-b") == 0) {
+		benchmark();
+		return 0;
+	}
+
+	bool ok = true;
+
+	ok = testDecodeRandom() && ok;
+	ok = testDecodeNoisy()  && ok;
+	ok = testDecodeClean()  && ok;
+	ok = testEncode()       && ok;
+
+	::fprintf(stdout, "%s\n", ok ? "All YSFConvolution tests passed" : "YSFConvolution tests FAILED");
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,251 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "YSFInterleaver.h"
+#include "YSFDefines.h"
+#include "YSFFICH.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+const unsigned int BLOCK_LENGTH = YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
+const unsigned int FICH_BITS    = YSF_FICH_LENGTH_BYTES * 8U;
+
+constexpr CYSFInterleaver<5U, 20U> INTERLEAVER;
+
+static std::mt19937 generator(0x46494348U);
+
+// The sync and an encoded random FICH
+static void createBlock(unsigned char* block)
+{
+	unsigned char raw[4U];
+	for (unsigned int i = 0U; i < 4U; i++)
+		raw[i] = uint8_t(generator());
+
+	::memcpy(block, YSF_SYNC_BYTES, YSF_SYNC_LENGTH_BYTES);
+
+	CYSFFICH fich;
+	fich.setRaw(raw);
+	fich.encode(block);
+}
+
+static void flipBit(unsigned char* block, unsigned int pos)
+{
+	block[YSF_SYNC_LENGTH_BYTES + (pos >> 3)] ^= 0x80U >> (pos & 7U);
+}
+
+// The in place rewrite of the DG-ID must give the same frame as decoding,
+// setting the DG-ID and encoding again, and so must a decode from the cache
+static bool compare(const unsigned char* received, unsigned char id)
+{
+	unsigned char full[BLOCK_LENGTH];
+	::memcpy(full, received, BLOCK_LENGTH);
+
+	CYSFFICH reference;
+	bool valid1 = reference.decode(full);
+	if (valid1) {
+		reference.setDGId(id);
+		reference.encode(full);
+	}
+
+	for (unsigned int n = 0U; n < 2U; n++) {
+		unsigned char fast[BLOCK_LENGTH];
+		::memcpy(fast, received, BLOCK_LENGTH);
+
+		CYSFFICH fich;
+		bool valid2 = fich.decode(fast);
+		if (valid2)
+			fich.setDGId(id, fast);
+
+		if (valid1 != valid2) {
+			::fprintf(stderr, "The FICH decoded as %s and %s\n", valid1 ? "valid" : "invalid", valid2 ? "valid" : "invalid");
+			return false;
+		}
+
+		unsigned char raw1[4U], raw2[4U];
+		reference.getRaw(raw1);
+		fich.getRaw(raw2);
+
+		if (::memcmp(full, fast, BLOCK_LENGTH) != 0 || (valid1 && ::memcmp(raw1, raw2, 4U) != 0)) {
+			::fprintf(stderr, "Setting DG-ID %u in place differs from a full encode\n", id);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Every old and new DG-ID with clean blocks
+static bool testClean()
+{
+	for (unsigned int n = 0U; n < 200U; n++) {
+		unsigned char block[BLOCK_LENGTH];
+		createBlock(block);
+
+		for (unsigned int id = 0U; id < 128U; id++) {
+			if (!compare(block, id))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// Errors in the first coded dibits look to the Viterbi decoder like the
+// encoder starting from a non-zero state, so they are corrected with a zero
+// path metric. Such a block must still be treated as damaged.
+static bool testStartErrors()
+{
+	for (unsigned int n = 0U; n < 100U; n++) {
+		unsigned char block[BLOCK_LENGTH];
+		createBlock(block);
+
+		for (unsigned int pattern = 1U; pattern < 256U; pattern++) {
+			unsigned char coded[YSF_FICH_LENGTH_BYTES];
+			::memset(coded, 0x00U, YSF_FICH_LENGTH_BYTES);
+			coded[0U] = pattern;
+
+			unsigned char errors[YSF_FICH_LENGTH_BYTES];
+			INTERLEAVER.interleave(coded, errors);
+
+			unsigned char received[BLOCK_LENGTH];
+			::memcpy(received, block, BLOCK_LENGTH);
+			for (unsigned int i = 0U; i < YSF_FICH_LENGTH_BYTES; i++)
+				received[YSF_SYNC_LENGTH_BYTES + i] ^= errors[i];
+
+			if (!compare(received, generator() & 0x7FU))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// Every error pattern of one and two bits
+static bool testTwoBitErrors()
+{
+	for (unsigned int n = 0U; n < 4U; n++) {
+		unsigned char block[BLOCK_LENGTH];
+		createBlock(block);
+
+		for (unsigned int i = 0U; i < FICH_BITS; i++) {
+			for (unsigned int j = i; j < FICH_BITS; j++) {
+				unsigned char received[BLOCK_LENGTH];
+				::memcpy(received, block, BLOCK_LENGTH);
+
+				flipBit(received, i);
+				if (j != i)
+					flipBit(received, j);
+
+				if (!compare(received, generator() & 0x7FU))
+					return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Heavier damage, some of which cannot be corrected
+static bool testRandomErrors()
+{
+	for (unsigned int n = 0U; n < 200000U; n++) {
+		unsigned char block[BLOCK_LENGTH];
+		createBlock(block);
+
+		unsigned int nErrors = 3U + generator() % 10U;
+		for (unsigned int i = 0U; i < nErrors; i++)
+			flipBit(block, generator() % FICH_BITS);
+
+		if (!compare(block, generator() & 0x7FU))
+			return false;
+	}
+
+	return true;
+}
+
+static void benchmark()
+{
+	const unsigned int FRAMES = 1000000U;
+
+	// A transmission cycling through the frame numbers, as the gateway sees
+	unsigned char blocks[8U][BLOCK_LENGTH];
+	for (unsigned int fn = 0U; fn < 8U; fn++) {
+		unsigned char raw[4U] = {0x22U, uint8_t((fn << 3) | 0x07U), 0x02U, 0x00U};
+
+		::memcpy(blocks[fn], YSF_SYNC_BYTES, YSF_SYNC_LENGTH_BYTES);
+
+		CYSFFICH fich;
+		fich.setRaw(raw);
+		fich.encode(blocks[fn]);
+	}
+
+	unsigned int check = 0U;
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned int n = 0U; n < FRAMES; n++) {
+		unsigned char block[BLOCK_LENGTH];
+		::memcpy(block, blocks[n % 8U], BLOCK_LENGTH);
+
+		CYSFFICH fich;
+		fich.decode(block);
+		fich.setDGId(n & 0x7FU);
+		fich.encode(block);
+		check += block[BLOCK_LENGTH - 1U];
+	}
+	auto middle = std::chrono::steady_clock::now();
+	for (unsigned int n = 0U; n < FRAMES; n++) {
+		unsigned char block[BLOCK_LENGTH];
+		::memcpy(block, blocks[n % 8U], BLOCK_LENGTH);
+
+		CYSFFICH fich;
+		fich.decode(block);
+		fich.setDGId(n & 0x7FU, block);
+		check -= block[BLOCK_LENGTH - 1U];
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	if (check != 0U)
+		::fprintf(stderr, "The DG-ID rewrites disagree\n");
+
+	double full    = std::chrono::duration<double, std::nano>(middle - start).count() / double(FRAMES);
+	double inPlace = std::chrono::duration<double, std::nano>(end - middle).count() / double(FRAMES);
+
+	::fprintf(stdout, "FICH decode and DG-ID rewrite: full encode %.1f ns, in place %.1f ns, %.2fx\n", full, inPlace, full / inPlace);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && ::strcmp(argv[1], "-b") == 0) {
+		benchmark();
+		return 0;
+	}
+
+	bool ok = true;
+
+	ok = testClean()        && ok;
+	ok = testStartErrors()  && ok;
+	ok = testTwoBitErrors() && ok;
+	ok = testRandomErrors() && ok;
+
+	::fprintf(stdout, "%s\n", ok ? "All YSFFICH tests passed" : "YSFFICH tests FAILED");
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "YSFInterleaver.h"
+#include "OriginalTables.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+const unsigned int MAX_DIBITS = 180U;
+
+static std::mt19937 generator(0x494C5653U);
+
+static bool readBit(const unsigned char* p, unsigned int i)
+{
+	return (p[i >> 3] & (0x80U >> (i & 7U))) != 0U;
+}
+
+static void writeBit(unsigned char* p, unsigned int i, bool b)
+{
+	if (b)
+		p[i >> 3] |= 0x80U >> (i & 7U);
+	else
+		p[i >> 3] &= ~(0x80U >> (i & 7U));
+}
+
+// The original bit at a time deinterleave and interleave through a table
+static void referenceDeinterleave(const unsigned int* table, unsigned int nDibits, const unsigned char* in, unsigned char* out)
+{
+	for (unsigned int i = 0U; i < nDibits; i++) {
+		unsigned int n = table[i];
+		out[i] = (readBit(in, n) ? 0x02U : 0x00U) | (readBit(in, n + 1U) ? 0x01U : 0x00U);
+	}
+}
+
+static void referenceInterleave(const unsigned int* table, unsigned int nDibits, const unsigned char* in, unsigned char* out)
+{
+	unsigned int j = 0U;
+	for (unsigned int i = 0U; i < nDibits; i++) {
+		unsigned int n = table[i];
+		writeBit(out, n, readBit(in, j++));
+		writeBit(out, n + 1U, readBit(in, j++));
+	}
+}
+
+// Each input bit on its own pins down the permutation, random blocks check
+// the whole of it at once
+template <unsigned int COLUMNS, unsigned int ROWS>
+static bool compare(const char* name, const unsigned int* table)
+{
+	const unsigned int N_DIBITS = COLUMNS * ROWS;
+	const unsigned int N_BYTES  = N_DIBITS / 4U;
+
+	constexpr CYSFInterleaver<COLUMNS, ROWS> interleaver;
+
+	for (unsigned int n = 0U; n < (N_DIBITS * 2U + 1000U); n++) {
+		unsigned char in[MAX_DIBITS / 4U];
+		if (n < (N_DIBITS * 2U)) {
+			::memset(in, 0x00U, N_BYTES);
+			writeBit(in, n, true);
+		} else {
+			for (unsigned int i = 0U; i < N_BYTES; i++)
+				in[i] = uint8_t(generator());
+		}
+
+		unsigned char dibits1[MAX_DIBITS], dibits2[MAX_DIBITS];
+		interleaver.deinterleave(in, dibits1);
+		referenceDeinterleave(table, N_DIBITS, in, dibits2);
+
+		if (::memcmp(dibits1, dibits2, N_DIBITS) != 0) {
+			::fprintf(stderr, "%s deinterleave differs from the original table\n", name);
+			return false;
+		}
+
+		unsigned char out1[MAX_DIBITS / 4U], out2[MAX_DIBITS / 4U];
+		::memset(out2, 0x00U, N_BYTES);
+
+		interleaver.interleave(in, out1);
+		referenceInterleave(table, N_DIBITS, in, out2);
+
+		if (::memcmp(out1, out2, N_BYTES) != 0) {
+			::fprintf(stderr, "%s interleave differs from the original table\n", name);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int main()
+{
+	bool ok = true;
+
+	ok = compare<5U, 20U>("FICH", FICH_INTERLEAVE_TABLE) && ok;
+	ok = compare<5U, 20U>("5x20", INTERLEAVE_TABLE_5_20) && ok;
+	ok = compare<9U, 20U>("9x20", INTERLEAVE_TABLE_9_20) && ok;
+
+	::fprintf(stdout, "%s\n", ok ? "All YSFInterleaver tests passed" : "YSFInterleaver tests FAILED");
+
+	return ok ? 0 : 1;
+}
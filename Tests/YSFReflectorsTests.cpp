@@ -0,0 +1,111 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "YSFReflectors.h"
+#include "Log.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static CYSFReflectorList* createList()
+{
+	// In upper case, as CYSFReflectors::build() leaves them
+	const char* NAMES[] = {"GB-TEST", "US-AMERICA-LINK", "DE-SIXTEEN-CHARS", "FR-CAF\xC3\xA9"};
+
+	std::vector<CYSFReflector> reflectors;
+	for (unsigned int i = 0U; i < sizeof(NAMES) / sizeof(NAMES[0U]); i++) {
+		CYSFReflector reflector;
+		reflector.setId(std::to_string(10000U + i));
+		reflector.setName(NAMES[i]);
+		reflectors.push_back(reflector);
+	}
+
+	return new CYSFReflectorList(std::move(reflectors));
+}
+
+static bool testFindByName(const CYSFReflectorList& list)
+{
+	// Case and trailing spaces are ignored, the whole name must match
+	const char* FOUND[]   = {"GB-Test", "gb-test", "DE-Sixteen-Chars", "de-sixteen-chars    ", "FR-Caf\xC3\xA9"};
+	const char* MISSING[] = {"GB-Tes", "DE-Sixteen-CharsX", "DE-Sixteen-Chars Extra", ""};
+
+	for (const auto& name : FOUND) {
+		if (list.findByName(name) == nullptr) {
+			::fprintf(stderr, "\"%s\" was not found\n", name);
+			return false;
+		}
+	}
+
+	for (const auto& name : MISSING) {
+		if (list.findByName(name) != nullptr) {
+			::fprintf(stderr, "\"%s\" was found\n", name);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool testSearch(const CYSFReflectorList& list)
+{
+	struct {
+		const char*  m_text;
+		unsigned int m_count;
+	} SEARCHES[] = {
+		{"-",                      4U},
+		{"sixteen",                1U},
+		{"DE-Sixteen-Chars",       1U},
+		{"de-sixteen-chars      ", 1U},
+		{"DE-Sixteen-CharsX",      0U},
+		{"E-Sixteen-Chars-Too",    0U},
+		{"Caf\xC3\xA9",            1U}
+	};
+
+	for (const auto& search : SEARCHES) {
+		std::vector<const CYSFReflector*> results;
+		list.search(search.m_text, results);
+
+		if (results.size() != search.m_count) {
+			::fprintf(stderr, "Searching for \"%s\" found %u, expected %u\n", search.m_text, (unsigned int)results.size(), search.m_count);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int main()
+{
+	::LogInitialise(2U, 0U);
+
+	CYSFReflectorList* list = createList();
+
+	bool ok = true;
+
+	ok = testFindByName(*list) && ok;
+	ok = testSearch(*list)     && ok;
+
+	delete list;
+
+	::fprintf(stdout, "%s\n", ok ? "All YSFReflectors tests passed" : "YSFReflectors tests FAILED");
+
+	::LogFinalise();
+
+	return ok ? 0 : 1;
+}
@@ -80,6 +80,7 @@ m_networkInactivityTimeout(0U),
 m_networkReconnect(false),
 m_networkRevert(false),
 m_networkDebug(false),
+m_networkReceiveBudget(20U),
 m_ysfNetworkEnabled(false),
 m_ysfNetworkPort(0U),
 m_ysfNetworkHosts(),
@@ -257,6 +258,8 @@ bool CConf::read()
 				m_networkRevert = ::atoi(value) == 1;
 			else if (::strcmp(key, "Debug") == 0)
 				m_networkDebug = ::atoi(value) == 1;
+			else if (::strcmp(key, "ReceiveBudget") == 0)
+				m_networkReceiveBudget = (unsigned int)::atoi(value);
 		} else if (section == SECTION::YSF_NETWORK) {
 			if (::strcmp(key, "Enable") == 0)
 				m_ysfNetworkEnabled = ::atoi(value) == 1;
@@ -492,6 +495,11 @@ bool CConf::getNetworkDebug() const
 	return m_networkDebug;
 }
 
+unsigned int CConf::getNetworkReceiveBudget() const
+{
+	return m_networkReceiveBudget;
+}
+
 bool CConf::getYSFNetworkEnabled() const
 {
 	return m_ysfNetworkEnabled;
@@ -80,6 +80,7 @@ public:
 	bool         getNetworkReconnect() const;
 	bool         getNetworkRevert() const;
 	bool         getNetworkDebug() const;
+	unsigned int getNetworkReceiveBudget() const;
 
 	// The YSF Network section
 	bool         getYSFNetworkEnabled() const;
@@ -152,6 +153,7 @@ private:
 	bool         m_networkReconnect;
 	bool         m_networkRevert;
 	bool         m_networkDebug;
+	unsigned int m_networkReceiveBudget;
 
 	bool         m_ysfNetworkEnabled;
 	unsigned short m_ysfNetworkPort;
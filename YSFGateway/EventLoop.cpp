@@ -0,0 +1,109 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "EventLoop.h"
+#include "Thread.h"
+#include "Log.h"
+
+#include <cassert>
+
+CEventLoop::CEventLoop(unsigned int tick) :
+m_tick(tick),
+m_sockets(),
+m_fds(),
+m_index(),
+m_readable()
+{
+	assert(tick > 0U);
+}
+
+CEventLoop::~CEventLoop()
+{
+}
+
+unsigned int CEventLoop::addSocket(const CUDPSocket& socket)
+{
+	m_sockets.push_back(&socket);
+	m_readable.push_back(false);
+
+	return (unsigned int)(m_sockets.size() - 1U);
+}
+
+bool CEventLoop::wait()
+{
+	m_fds.clear();
+	m_index.clear();
+
+	for (unsigned int i = 0U; i < m_sockets.size(); i++) {
+		m_readable[i] = false;
+
+		const CUDPSocket* socket = m_sockets[i];
+		if (!socket->isOpen())
+			continue;
+
+		struct pollfd pfd;
+		pfd.fd      = socket->getFd();
+		pfd.events  = POLLIN;
+		pfd.revents = 0;
+
+		m_fds.push_back(pfd);
+		m_index.push_back(i);
+	}
+
+	// Nothing to wait on, just let the timers run
+	if (m_fds.empty()) {
+		CThread::sleep(m_tick);
+		return false;
+	}
+
+#if defined(_WIN32) || defined(_WIN64)
+	int ret = WSAPoll(m_fds.data(), ULONG(m_fds.size()), int(m_tick));
+#else
+	int ret = ::poll(m_fds.data(), nfds_t(m_fds.size()), int(m_tick));
+#endif
+	if (ret < 0) {
+#if defined(_WIN32) || defined(_WIN64)
+		LogError("Error returned from poll in the event loop, err: %lu", ::GetLastError());
+#else
+		if (errno == EINTR)
+			return false;
+
+		LogError("Error returned from poll in the event loop, err: %d", errno);
+#endif
+		CThread::sleep(m_tick);
+		return false;
+	}
+
+	if (ret == 0)
+		return false;
+
+	// An error on a socket counts too, as reading it is what clears it
+	for (unsigned int i = 0U; i < m_fds.size(); i++) {
+		if (m_fds[i].revents != 0)
+			m_readable[m_index[i]] = true;
+	}
+
+	return true;
+}
+
+bool CEventLoop::isReadable(unsigned int n) const
+{
+	assert(n < m_readable.size());
+
+	return m_readable[n];
+}
@@ -0,0 +1,52 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(EVENTLOOP_H)
+#define	EVENTLOOP_H
+
+#include "UDPSocket.h"
+
+#include <vector>
+
+// Blocks the main loop until one of the registered sockets has data waiting
+// or the timer tick has passed, whichever comes first. The sockets are
+// re-read on every wait so that a socket that has been closed and re-opened,
+// as the YSF network does on every link, is picked up automatically. After
+// a wait each socket can be asked whether it had data, by the number it was
+// given when it was added.
+class CEventLoop
+{
+public:
+	CEventLoop(unsigned int tick);
+	~CEventLoop();
+
+	unsigned int addSocket(const CUDPSocket& socket);
+
+	bool wait();
+
+	bool isReadable(unsigned int n) const;
+
+private:
+	unsigned int                   m_tick;
+	std::vector<const CUDPSocket*> m_sockets;
+	std::vector<pollfd>            m_fds;
+	std::vector<unsigned int>      m_index;
+	std::vector<bool>              m_readable;
+};
+
+#endif
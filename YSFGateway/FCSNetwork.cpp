@@ -29,8 +29,11 @@ const char* FCS_VERSION = "MMDVM";
 
 const unsigned int BUFFER_LENGTH = 200U;
 
-CFCSNetwork::CFCSNetwork(unsigned short port, const std::string& callsign, unsigned int rxFrequency, unsigned int txFrequency, const std::string& locator, unsigned int id, bool debug) :
+const unsigned int DEFAULT_RECEIVE_BUDGET = 20U;
+
+CFCSNetwork::CFCSNetwork(unsigned short port, const std::string& callsign, unsigned int rxFrequency, unsigned int txFrequency, const std::string& locator, unsigned int id, CDNSResolver& resolver, bool debug) :
 m_socket(port),
+m_resolver(resolver),
 m_debug(debug),
 m_addr(),
 m_addrLen(),
@@ -40,11 +43,16 @@ m_opt(),
 m_info(nullptr),
 m_reflector(),
 m_print(),
-m_buffer(1000U, "FCS Network Buffer"),
+m_buffer(5000U, "FCS Network Buffer"),
 m_n(0U),
 m_pingTimer(1000U, 0U, 800U),
 m_resetTimer(1000U, 1U),
-m_state(FCS_STATE::UNLINKED)
+m_state(FCS_STATE::UNLINKED),
+m_budget(DEFAULT_RECEIVE_BUDGET),
+m_drained(0U),
+m_wakeups(0U),
+m_maxDrained(0U),
+m_linkId(0U)
 {
 	m_info = new unsigned char[100U];
 	::sprintf((char*)m_info, "%9u%9u%-6.6s%-12.12s%7u", rxFrequency, txFrequency, locator.c_str(), FCS_VERSION, id);
@@ -115,26 +123,56 @@ void CFCSNetwork::write(const unsigned char* data)
 	m_socket.write(buffer, 130U, m_addr, m_addrLen);
 }
 
-bool CFCSNetwork::writeLink(const std::string& reflector)
+void CFCSNetwork::writeLink(const std::string& reflector, FCSLinkCallback callback)
 {
-	if (m_state != FCS_STATE::LINKED) {
-		std::string name = reflector.substr(0U, 6U);
-		
-		if (m_addresses.count(name) == 0U) {			
-			char url[30U];
-			::sprintf(url, "%s.xreflector.net", name.c_str());
-
-			if (CUDPSocket::lookup(url, FCS_PORT, m_addr, m_addrLen) != 0) {
-				LogWarning("Unknown FCS reflector - %s", name.c_str());
-				return false;
-			}
-   		} else {
-			std::pair<sockaddr_storage, unsigned int> entry = m_addresses[name];
-			m_addr    = entry.first;
-			m_addrLen = entry.second;
-   		}
+	// Any link still waiting on its address is replaced by this one
+	unsigned int id = ++m_linkId;
+
+	if (m_state == FCS_STATE::LINKED) {
+		link(reflector);
+		callback(true);
+		return;
 	}
 
+	std::string name = reflector.substr(0U, 6U);
+
+	if (m_addresses.count(name) > 0U) {
+		std::pair<sockaddr_storage, unsigned int> entry = m_addresses[name];
+		m_addr    = entry.first;
+		m_addrLen = entry.second;
+
+		link(reflector);
+		callback(true);
+		return;
+	}
+
+	char url[30U];
+	::sprintf(url, "%s.xreflector.net", name.c_str());
+
+	m_state = FCS_STATE::RESOLVING;
+	m_pingTimer.stop();
+
+	m_resolver.lookup(url, FCS_PORT, [this, id, reflector, name, callback](bool found, const sockaddr_storage& addr, unsigned int addrLen) {
+		if (m_state != FCS_STATE::RESOLVING || m_linkId != id)
+			return;
+
+		if (!found) {
+			LogWarning("Unknown FCS reflector - %s", name.c_str());
+			m_state = FCS_STATE::UNLINKED;
+			callback(false);
+			return;
+		}
+
+		m_addr    = addr;
+		m_addrLen = addrLen;
+
+		link(reflector);
+		callback(true);
+	});
+}
+
+void CFCSNetwork::link(const std::string& reflector)
+{
 	m_reflector = reflector;
 	::memcpy(m_ping + 10U, reflector.c_str(), 8U);
 
@@ -145,8 +183,6 @@ bool CFCSNetwork::writeLink(const std::string& reflector)
 	m_pingTimer.start();
 
 	writePing();
-
-	return true;
 }
 
 void CFCSNetwork::setOptions(const std::string& options)
@@ -159,8 +195,28 @@ void CFCSNetwork::writeUnlink(unsigned int count)
 	if (m_state != FCS_STATE::LINKED)
 		return;
 
-	for (unsigned int i = 0U; i < count; i++)
-		m_socket.write((unsigned char*)"CLOSE      ", 11U, m_addr, m_addrLen);
+	if (count == 0U)
+		return;
+
+	if (count > UDP_BATCH_SIZE)
+		count = UDP_BATCH_SIZE;
+
+	UDPDatagram datagrams[UDP_BATCH_SIZE];
+	for (unsigned int i = 0U; i < count; i++) {
+		datagrams[i].m_buffer  = (unsigned char*)"CLOSE      ";
+		datagrams[i].m_length  = 11U;
+		datagrams[i].m_addr    = m_addr;
+		datagrams[i].m_addrLen = m_addrLen;
+	}
+
+	m_socket.write(datagrams, count);
+}
+
+void CFCSNetwork::setReceiveBudget(unsigned int budget)
+{
+	assert(budget > 0U);
+
+	m_budget = budget;
 }
 
 void CFCSNetwork::clock(unsigned int ms)
@@ -177,15 +233,60 @@ void CFCSNetwork::clock(unsigned int ms)
 		m_resetTimer.stop();
 	}
 
-	unsigned char buffer[BUFFER_LENGTH];
+	unsigned char buffers[UDP_BATCH_SIZE][BUFFER_LENGTH];
+	UDPDatagram datagrams[UDP_BATCH_SIZE];
+
+	// Empty the socket each pass, up to the budget, so that a burst isn't left queued in the kernel
+	unsigned int count = 0U;
+	while (count < m_budget) {
+		// Only take as many as the ring buffer can hold
+		unsigned int wanted = (m_buffer.freeSpace() - 1U) / (BUFFER_LENGTH + 1U);
+		if (wanted > (m_budget - count))
+			wanted = m_budget - count;
+		if (wanted > UDP_BATCH_SIZE)
+			wanted = UDP_BATCH_SIZE;
+		if (wanted == 0U)
+			break;
+
+		for (unsigned int i = 0U; i < wanted; i++) {
+			datagrams[i].m_buffer = buffers[i];
+			datagrams[i].m_length = BUFFER_LENGTH;
+		}
+
+		int n = m_socket.read(datagrams, wanted);
+		if (n <= 0)
+			break;
+
+		for (int i = 0; i < n; i++)
+			receive(datagrams[i].m_buffer, datagrams[i].m_length, datagrams[i].m_addr);
+
+		count += n;
+
+		// A short batch means the socket is now empty
+		if ((unsigned int)n < wanted)
+			break;
+	}
 
-	sockaddr_storage addr;
-	unsigned int addrLen;
-	int length = m_socket.read(buffer, BUFFER_LENGTH, addr, addrLen);
-	if (length <= 0)
+	if (count == 0U)
 		return;
 
-	if (m_state == FCS_STATE::UNLINKED)
+	// Kept for the report when the connection is closed
+	m_drained += count;
+	m_wakeups++;
+
+	if (count > m_maxDrained) {
+		m_maxDrained = count;
+
+		if (m_debug)
+			LogDebug("FCS Network drained %u packets in one pass, budget %u", count, m_budget);
+	}
+}
+
+void CFCSNetwork::receive(const unsigned char* buffer, unsigned int length, const sockaddr_storage& addr)
+{
+	assert(buffer != nullptr);
+
+	if (m_state == FCS_STATE::UNLINKED || m_state == FCS_STATE::RESOLVING)
 		return;
 
 	if (!CUDPSocket::match(addr, m_addr))
@@ -259,9 +360,21 @@ void CFCSNetwork::close()
 {
 	m_socket.close();
 
+	if (m_wakeups > 0U)
+		LogMessage("FCS Network received %u packets in %u passes, at most %u in one pass", m_drained, m_wakeups, m_maxDrained);
+
+	m_drained    = 0U;
+	m_wakeups    = 0U;
+	m_maxDrained = 0U;
+
 	LogMessage("Closing FCS network connection");
 }
 
+const CUDPSocket& CFCSNetwork::getSocket() const
+{
+	return m_socket;
+}
+
 void CFCSNetwork::writeInfo()
 {
 	if (m_state != FCS_STATE::LINKED)
@@ -275,7 +388,7 @@ void CFCSNetwork::writeInfo()
 
 void CFCSNetwork::writePing()
 {
-	if (m_state == FCS_STATE::UNLINKED)
+	if (m_state == FCS_STATE::UNLINKED || m_state == FCS_STATE::RESOLVING)
 		return;
 
 	if (m_debug)
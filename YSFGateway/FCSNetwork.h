@@ -20,23 +20,29 @@
 #define	FCSNetwork_H
 
 #include "YSFDefines.h"
+#include "DNSResolver.h"
 #include "UDPSocket.h"
 #include "RingBuffer.h"
 #include "Timer.h"
 
+#include <functional>
 #include <cstdint>
 #include <string>
 #include <map>
 
 enum class FCS_STATE {
 	UNLINKED,
+	RESOLVING,
 	LINKING,
 	LINKED
 };
 
+// Told whether the link has been started, once the address of the room is known
+typedef std::function<void(bool linked)> FCSLinkCallback;
+
 class CFCSNetwork {
 public:
-	CFCSNetwork(unsigned short port, const std::string& callsign, unsigned int rxFrequency, unsigned int txFrequency, const std::string& locator, unsigned int id, bool debug);
+	CFCSNetwork(unsigned short port, const std::string& callsign, unsigned int rxFrequency, unsigned int txFrequency, const std::string& locator, unsigned int id, CDNSResolver& resolver, bool debug);
 	~CFCSNetwork();
 
 	bool open();
@@ -47,18 +53,27 @@ public:
 
 	void write(const unsigned char* data);
 
-	bool writeLink(const std::string& reflector);
+	// The address of the room may have to be resolved first, so the outcome
+	// is passed to the callback, either straight away or later from the
+	// resolver's clock(). A link that is replaced or cleared before then is
+	// dropped without the callback being run.
+	void writeLink(const std::string& reflector, FCSLinkCallback callback);
 
 	void writeUnlink(unsigned int count = 1U);
 
+	void setReceiveBudget(unsigned int budget);
+
 	unsigned int read(unsigned char* data);
 
 	void clock(unsigned int ms);
 
 	void close();
 
+	const CUDPSocket& getSocket() const;
+
 private:
 	CUDPSocket                     m_socket;
+	CDNSResolver&                  m_resolver;
 	bool                           m_debug;
 	sockaddr_storage               m_addr;
 	unsigned int                   m_addrLen;
@@ -74,6 +89,15 @@ private:
 	CTimer                         m_pingTimer;
 	CTimer                         m_resetTimer;
 	FCS_STATE                      m_state;
+	unsigned int                   m_budget;
+	unsigned int                   m_drained;
+	unsigned int                   m_wakeups;
+	unsigned int                   m_maxDrained;
+	unsigned int                   m_linkId;
+
+	void receive(const unsigned char* buffer, unsigned int length, const sockaddr_storage& addr);
+
+	void link(const std::string& reflector);
 
 	void writeOptions(const std::string& reflector);
 	void writeInfo();
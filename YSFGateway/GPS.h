@@ -20,7 +20,7 @@
 #define	GPS_H
 
 #include "APRSWriter.h"
-#include "YSFFICH.h"
+#include "YSFFrameView.h"
 
 #include <string>
 
@@ -29,13 +29,13 @@ public:
 	CGPS(CAPRSWriter* writer);
 	~CGPS();
 
-	void data(const unsigned char* source, const unsigned char* data, const CYSFFICH& fich);
+	void data(CYSFFrameView& frame);
 
 	void reset();
 
 private:
 	CAPRSWriter*   m_writer;
-	unsigned char* m_buffer;
+	unsigned char  m_buffer[300U];
 	bool           m_sent;
 
 	void transmitGPS(const unsigned char* source);
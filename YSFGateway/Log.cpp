@@ -56,10 +56,22 @@ void LogFinalise()
 	}
 }
 
+bool LogEnabled(unsigned int level)
+{
+	if (m_mqtt != nullptr && level >= m_mqttLevel && m_mqttLevel != 0U)
+		return true;
+
+	return level >= m_displayLevel && m_displayLevel != 0U;
+}
+
 void Log(unsigned int level, const char* fmt, ...)
 {
 	assert(fmt != nullptr);
 
+	// Don't format anything that nobody will see
+	if (level != 6U && !LogEnabled(level))
+		return;
+
 	char buffer[501U];
 #if defined(_WIN32) || defined(_WIN64)
 	SYSTEMTIME st;
@@ -21,6 +21,8 @@
 
 #include <string>
 
+#include <cstddef>
+
 #if !defined(_WIN32) && !defined(_WIN64)
 #include <netdb.h>
 #include <sys/time.h>
@@ -40,6 +42,18 @@ enum class IPMATCHTYPE {
 	ADDRESS_ONLY
 };
 
+// The most datagrams handed to the kernel in one batched read or write. A
+// batched read may be asked for no more than this, a batched write sends
+// any number, this many at a time.
+const unsigned int UDP_BATCH_SIZE = 16U;
+
+struct UDPDatagram {
+	unsigned char*   m_buffer;
+	unsigned int     m_length;
+	sockaddr_storage m_addr;
+	unsigned int     m_addrLen;
+};
+
 class CUDPSocket {
 public:
 	CUDPSocket(const std::string& address, unsigned short port = 0U);
@@ -52,8 +66,18 @@ public:
 	int  read(unsigned char* buffer, unsigned int length, sockaddr_storage& address, unsigned int &addressLength);
 	bool write(const unsigned char* buffer, unsigned int length, const sockaddr_storage& address, unsigned int addressLength);
 
+	int          read(UDPDatagram* datagrams, unsigned int count);
+	unsigned int write(const UDPDatagram* datagrams, unsigned int count);
+
 	void close();
 
+	bool isOpen() const;
+#if defined(_WIN32) || defined(_WIN64)
+	SOCKET getFd() const;
+#else
+	int    getFd() const;
+#endif
+
 	static void startup();
 	static void shutdown();
 
@@ -74,4 +98,17 @@ private:
 #endif
 };
 
+// Lets a sockaddr_storage be the key of an unordered container, the address
+// and the port are both used, in the same way as CUDPSocket::match()
+struct CUDPAddressHash {
+	size_t operator()(const sockaddr_storage& addr) const;
+};
+
+struct CUDPAddressEqual {
+	bool operator()(const sockaddr_storage& addr1, const sockaddr_storage& addr2) const
+	{
+		return CUDPSocket::match(addr1, addr2);
+	}
+};
+
 #endif
@@ -18,8 +18,8 @@
 
 class CUtils {
 public:
-	static void dump(const std::string& title, const unsigned char* data, unsigned int length);
-	static void dump(int level, const std::string& title, const unsigned char* data, unsigned int length);
+	static void dump(const char* title, const unsigned char* data, unsigned int length);
+	static void dump(int level, const char* title, const unsigned char* data, unsigned int length);
 
 	static std::string createTimestamp();
 
@@ -24,6 +24,7 @@
 #include "CRC.h"
 #include "Log.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cassert>
 #include <cstdlib>
@@ -44,26 +45,34 @@ const unsigned char DEFAULT_FICH[] = {0x20U, 0x00U, 0x01U, 0x00U};
 
 const unsigned char NET_HEADER[] = "YSFD                    ALL      ";
 
+// Enough for every ALL page of a large host list plus some searches
+const unsigned int MAX_PAGES = 200U;
+
 CWiresX::CWiresX(const std::string& callsign, const std::string& suffix, CYSFNetwork* network, CYSFReflectors& reflectors) :
 m_callsign(callsign),
 m_node(),
 m_network(network),
 m_reflectors(reflectors),
 m_reflector(nullptr),
+m_reflectorList(),
 m_id(),
 m_name(),
-m_command(nullptr),
+m_command(),
 m_txFrequency(0U),
 m_rxFrequency(0U),
 m_timer(1000U, 1U),
 m_seqNo(0U),
-m_header(nullptr),
-m_csd1(nullptr),
-m_csd2(nullptr),
-m_csd3(nullptr),
+m_header(),
+m_csd1(),
+m_csd2(),
+m_csd3(),
 m_status(WXSI_STATUS::NONE),
 m_start(0U),
 m_search(),
+m_category(),
+m_categoryList(),
+m_pages(),
+m_pageList(),
 m_busy(false),
 m_busyTimer(3000U, 1U),
 m_bufferTX(10000U, "YSF Wires-X TX Buffer")
@@ -79,23 +88,11 @@ m_bufferTX(10000U, "YSF Wires-X TX Buffer")
 
 	m_callsign.resize(YSF_CALLSIGN_LENGTH, ' ');
 
-	m_command = new unsigned char[300U];
-
-	m_header = new unsigned char[34U];
-	m_csd1   = new unsigned char[20U];
-	m_csd2   = new unsigned char[20U];
-	m_csd3   = new unsigned char[20U];
-
 	m_txWatch.start();
 }
 
 CWiresX::~CWiresX()
 {
-	delete[] m_csd3;
-	delete[] m_csd2;
-	delete[] m_csd1;
-	delete[] m_header;
-	delete[] m_command;
 }
 
 void CWiresX::setInfo(const std::string& name, unsigned int txFrequency, unsigned int rxFrequency)
@@ -186,10 +183,10 @@ bool CWiresX::start()
 	return true;
 }
 
-WX_STATUS CWiresX::process(const unsigned char* data, const unsigned char* source, const CYSFFICH& fich, bool wiresXCommandPassthrough)
+WX_STATUS CWiresX::process(CYSFFrameView& frame, bool wiresXCommandPassthrough)
 {
-	assert(data != nullptr);
-	assert(source != nullptr);
+	const CYSFFICH& fich = frame.getFICH();
+	const unsigned char* source = frame.getSource();
 
 	unsigned char dt = fich.getDT();
 	if (dt != YSF_DT_DATA_FR_MODE)
@@ -199,22 +196,20 @@ WX_STATUS CWiresX::process(const unsigned char* data, const unsigned char* sourc
 	if (fi != YSF_FI_COMMUNICATIONS)
 		return WX_STATUS::NONE;
 
-	CYSFPayload payload;
-
 	unsigned char fn = fich.getFN();
 	if (fn == 0U)
 		return WX_STATUS::NONE;
 
 	if (fn == 1U) {
-		bool valid = payload.readDataFRModeData2(data, m_command + 0U);
+		bool valid = frame.readDataFRModeData2(m_command + 0U);
 		if (!valid)
 			return WX_STATUS::NONE;
 	} else {
-		bool valid = payload.readDataFRModeData1(data, m_command + (fn - 2U) * 40U + 20U);
+		bool valid = frame.readDataFRModeData1(m_command + (fn - 2U) * 40U + 20U);
 		if (!valid)
 			return WX_STATUS::NONE;
 
-		valid = payload.readDataFRModeData2(data, m_command + (fn - 2U) * 40U + 40U);
+		valid = frame.readDataFRModeData2(m_command + (fn - 2U) * 40U + 40U);
 		if (!valid)
 			return WX_STATUS::NONE;
 	}
@@ -283,14 +278,16 @@ WX_STATUS CWiresX::process(const unsigned char* data, const unsigned char* sourc
 	return WX_STATUS::NONE;
 }
 
-CYSFReflector* CWiresX::getReflector() const
+const CYSFReflector* CWiresX::getReflector() const
 {
 	return m_reflector;
 }
 
-void CWiresX::setReflector(CYSFReflector* reflector)
+void CWiresX::setReflector(const CYSFReflector* reflector)
 {
-	m_reflector = reflector;
+	// Keep the list the reflector came from alive for as long as we use it
+	m_reflector     = reflector;
+	m_reflectorList = m_reflectors.current();
 }
 
 void CWiresX::processDX(const unsigned char* source)
@@ -318,6 +315,7 @@ void CWiresX::processCategory(const unsigned char* source, const unsigned char*
 		return;
 
 	m_category.clear();
+	m_categoryList = m_reflectors.current();
 
 	for (unsigned int j = 0U; j < len; j++) {
 		::memcpy(buffer, data + 7U + j * 5U, 5U);
@@ -325,7 +323,7 @@ void CWiresX::processCategory(const unsigned char* source, const unsigned char*
 
 		std::string id = std::string(buffer, 5U);
 
-		CYSFReflector* refl = m_reflectors.findById(id);
+		const CYSFReflector* refl = m_reflectors.findById(id);
 		if (refl)
 			m_category.push_back(refl);
 	}
@@ -374,7 +372,7 @@ WX_STATUS CWiresX::processConnect(const unsigned char* source, const unsigned ch
 
 	std::string id = std::string((char*)data, 5U);
 
-	m_reflector = m_reflectors.findById(id);
+	setReflector(m_reflectors.findById(id));
 	if (m_reflector == nullptr) {
 		if(source != nullptr)
 			processDisconnect(source);
@@ -396,12 +394,12 @@ WX_STATUS CWiresX::processConnect(const unsigned char* source, const unsigned ch
 	}
 }
 
-void CWiresX::processConnect(CYSFReflector* reflector)
+void CWiresX::processConnect(const CYSFReflector* reflector)
 {
 	m_busy = true;
 	m_busyTimer.start();
 
-	m_reflector = reflector;
+	setReflector(reflector);
 
 	m_status = WXSI_STATUS::CONNECT;
 	m_timer.start();
@@ -412,7 +410,7 @@ void CWiresX::processDisconnect(const unsigned char* source)
 	if (source != nullptr)
 		::LogDebug("Received Disconect from %10.10s", source);
 
-	m_reflector = nullptr;
+	setReflector(nullptr);
 
 	m_status = WXSI_STATUS::DISCONNECT;
 	m_timer.start();
@@ -485,6 +483,19 @@ void CWiresX::createReply(const unsigned char* data, unsigned int length, CYSFNe
 		network = m_network;
 	}
 
+	std::vector<unsigned char> frames;
+	std::vector<unsigned int> offsets;
+	encodeReply(data, length, frames, offsets);
+
+	for (unsigned int i = 0U; i < frames.size(); i += 155U)
+		writeData(frames.data() + i, network, sendWiresXtoNetwork);
+}
+
+void CWiresX::encodeReply(const unsigned char* data, unsigned int length, std::vector<unsigned char>& frames, std::vector<unsigned int>& offsets) const
+{
+	assert(data != nullptr);
+	assert(length > 0U);
+
 	unsigned char bt = 0U;
 
 	if (length > 260U) {
@@ -526,7 +537,8 @@ void CWiresX::createReply(const unsigned char* data, unsigned int length, CYSFNe
 	buffer[34U] = seqNo;
 	seqNo += 2U;
 
-	writeData(buffer, network, sendWiresXtoNetwork);
+	frames.insert(frames.end(), buffer, buffer + 155U);
+	offsets.push_back(0U);
 
 	fich.setFI(YSF_FI_COMMUNICATIONS);
 
@@ -535,34 +547,12 @@ void CWiresX::createReply(const unsigned char* data, unsigned int length, CYSFNe
 
 	unsigned int offset = 0U;
 	while (offset < length) {
-		switch (fn) {
-		case 0U: {
-				ft = calculateFT(length, offset);
-				payload.writeDataFRModeData1(m_csd1, buffer + 35U);
-				payload.writeDataFRModeData2(m_csd2, buffer + 35U);
-			}
-			break;
-		case 1U:
-			payload.writeDataFRModeData1(m_csd3, buffer + 35U);
-			if (bn == 0U) {
-				payload.writeDataFRModeData2(data + offset, buffer + 35U);
-				offset += 20U;
-			} else {
-				// All subsequent entries start with 0x00U
-				unsigned char temp[20U];
-				::memcpy(temp + 1U, data + offset, 19U);
-				temp[0U] = 0x00U;
-				payload.writeDataFRModeData2(temp, buffer + 35U);
-				offset += 19U;
-			}
-			break;
-		default:
-			payload.writeDataFRModeData1(data + offset, buffer + 35U);
-			offset += 20U;
-			payload.writeDataFRModeData2(data + offset, buffer + 35U);
-			offset += 20U;
-			break;
-		}
+		if (fn == 0U)
+			ft = calculateFT(length, offset);
+
+		offsets.push_back(offset);
+
+		offset = writePayload(payload, fn, bn, data, offset, buffer + 35U);
 
 		fich.setFT(ft);
 		fich.setFN(fn);
@@ -573,7 +563,7 @@ void CWiresX::createReply(const unsigned char* data, unsigned int length, CYSFNe
 		buffer[34U] = seqNo;
 		seqNo += 2U;
 
-		writeData(buffer, network, sendWiresXtoNetwork);
+		frames.insert(frames.end(), buffer, buffer + 155U);
 
 		fn++;
 		if (fn >= 8U) {
@@ -593,7 +583,101 @@ void CWiresX::createReply(const unsigned char* data, unsigned int length, CYSFNe
 
 	buffer[34U] = seqNo | 0x01U;
 
-	writeData(buffer, network, sendWiresXtoNetwork);
+	frames.insert(frames.end(), buffer, buffer + 155U);
+	offsets.push_back(offset);
+}
+
+unsigned int CWiresX::writePayload(CYSFPayload& payload, unsigned char fn, unsigned char bn, const unsigned char* data, unsigned int offset, unsigned char* buffer) const
+{
+	switch (fn) {
+	case 0U:
+		payload.writeDataFRModeData1(m_csd1, buffer);
+		payload.writeDataFRModeData2(m_csd2, buffer);
+		break;
+	case 1U:
+		payload.writeDataFRModeData1(m_csd3, buffer);
+		if (bn == 0U) {
+			payload.writeDataFRModeData2(data + offset, buffer);
+			offset += 20U;
+		} else {
+			// All subsequent entries start with 0x00U
+			unsigned char temp[20U];
+			::memcpy(temp + 1U, data + offset, 19U);
+			temp[0U] = 0x00U;
+			payload.writeDataFRModeData2(temp, buffer);
+			offset += 19U;
+		}
+		break;
+	default:
+		payload.writeDataFRModeData1(data + offset, buffer);
+		offset += 20U;
+		payload.writeDataFRModeData2(data + offset, buffer);
+		offset += 20U;
+		break;
+	}
+
+	return offset;
+}
+
+const CWiresXPage* CWiresX::findPage(const std::shared_ptr<const CYSFReflectorList>& list, const std::string& key)
+{
+	// A new host list makes every page out of date
+	if (list != m_pageList) {
+		m_pages.clear();
+		m_pageList = list;
+	}
+
+	auto it = m_pages.find(key);
+	if (it == m_pages.end())
+		return nullptr;
+
+	return &it->second;
+}
+
+const CWiresXPage* CWiresX::addPage(const std::string& key, const unsigned char* data, unsigned int length)
+{
+	assert(data != nullptr);
+
+	if (m_pages.size() >= MAX_PAGES)
+		m_pages.clear();
+
+	CWiresXPage& page = m_pages[key];
+	page.m_length = length;
+
+	encodeReply(data, length, page.m_frames, page.m_offsets);
+
+	page.m_data.assign(data, data + std::max(length, page.m_offsets.back()));
+
+	return &page;
+}
+
+void CWiresX::sendPage(const CWiresXPage& page, const char* title)
+{
+	unsigned int crcPos = page.m_length - 1U;
+
+	std::vector<unsigned char> data = page.m_data;
+	data.at(0U)      = m_seqNo;
+	data.at(crcPos) += m_seqNo;
+
+	CUtils::dump(1U, title, data.data(), page.m_length);
+
+	// Only the frames carrying the sequence number and the checksum differ
+	// from the cached copy, everything else is sent as it was encoded.
+	std::vector<unsigned char> frames = page.m_frames;
+
+	CYSFPayload payload;
+	for (unsigned int n = 1U; (n + 1U) < page.m_offsets.size(); n++) {
+		unsigned int start = page.m_offsets.at(n);
+		unsigned int end   = page.m_offsets.at(n + 1U);
+
+		bool seqNo = (start == 0U) && (end > 0U);
+		bool crc   = (start <= crcPos) && (crcPos < end);
+		if (seqNo || crc)
+			writePayload(payload, (n - 1U) % 8U, (n - 1U) / 8U, data.data(), start, frames.data() + n * 155U + 35U);
+	}
+
+	for (unsigned int i = 0U; i < frames.size(); i += 155U)
+		writeData(frames.data() + i, m_network, false);
 }
 
 void CWiresX::writeData(const unsigned char* buffer, CYSFNetwork* network, bool sendWiresXtoNetwork)
@@ -660,16 +744,16 @@ void CWiresX::sendDXReply()
 		data[35U] = '3'; // 0 = Offline 1 = Busy 2 = Disconnect 3 = Normal
 
 		for (unsigned int i = 0U; i < 5U; i++)
-			data[i + 36U] = m_reflector->m_id.at(i);
+			data[i + 36U] = m_reflector->m_id[i];
 
 		for (unsigned int i = 0U; i < 16U; i++)
-			data[i + 41U] = std::toupper(m_reflector->m_name.at(i));
+			data[i + 41U] = std::toupper(m_reflector->m_name[i]);
 
 		for (unsigned int i = 0U; i < 3U; i++)
-			data[i + 57U] = m_reflector->m_count.at(i);
+			data[i + 57U] = m_reflector->m_count[i];
 
 		for (unsigned int i = 0U; i < 14U; i++)
-			data[i + 70U] = m_reflector->m_desc.at(i);
+			data[i + 70U] = m_reflector->m_desc[i];
 	}
 
 	unsigned int offset;
@@ -748,16 +832,16 @@ void CWiresX::sendConnectReply()
 	data[35U] = '3'; // 0 = Offline 1 = Busy 2 = Disconnect 3 = Normal
 
 	for (unsigned int i = 0U; i < 5U; i++)
-	data[i + 36U] = m_reflector->m_id.at(i);
+	data[i + 36U] = m_reflector->m_id[i];
 
 	for (unsigned int i = 0U; i < 16U; i++)
-		data[i + 41U] = std::toupper(m_reflector->m_name.at(i));
+		data[i + 41U] = std::toupper(m_reflector->m_name[i]);
 
 	for (unsigned int i = 0U; i < 3U; i++)
-		data[i + 57U] = m_reflector->m_count.at(i);
+		data[i + 57U] = m_reflector->m_count[i];
 
 	for (unsigned int i = 0U; i < 14U; i++)
-		data[i + 70U] = m_reflector->m_desc.at(i);
+		data[i + 70U] = m_reflector->m_desc[i];
 
 	data[84U] = '0';
 	data[85U] = '0';
@@ -854,12 +938,22 @@ void CWiresX::sendAllReply()
 	if (m_start == 0U)
 		m_reflectors.reload();
 
-	std::vector<CYSFReflector*>& curr = m_reflectors.current();
+	std::shared_ptr<const CYSFReflectorList> curr = m_reflectors.current();
+
+	std::string key = "ALL/" + std::to_string(m_start);
+
+	const CWiresXPage* page = findPage(curr, key);
+	if (page != nullptr) {
+		sendPage(*page, "ALL Reply");
+		m_seqNo++;
+		return;
+	}
 
 	unsigned char data[1100U];
 	::memset(data, 0x00U, 1100U);
 
-	data[0U] = m_seqNo;
+	// The sequence number is added when the page is sent
+	data[0U] = 0x00U;
 
 	for (unsigned int i = 0U; i < 4U; i++)
 		data[i + 1U] = ALL_RESP[i];
@@ -873,10 +967,10 @@ void CWiresX::sendAllReply()
 	for (unsigned int i = 0U; i < 10U; i++)
 		data[i + 12U] = m_node.at(i);
 
-	unsigned int total = (unsigned int)curr.size();
+	unsigned int total = curr->size();
 	if (total > 999U) total = 999U;
 
-	unsigned int n = (unsigned int)curr.size() - m_start;
+	unsigned int n = curr->size() - m_start;
 	if (n > 20U) n = 20U;
 
 	::sprintf((char*)(data + 22U), "%03u%03u", 20U, total);
@@ -884,30 +978,8 @@ void CWiresX::sendAllReply()
 	data[28U] = 0x0DU;
 
 	unsigned int offset = 29U;
-	for (unsigned int j = 0U; j < n; j++, offset += 50U) {
-		CYSFReflector* refl = curr.at(j + m_start);
-
-		::memset(data + offset, ' ', 50U);
-
-		data[offset + 0U] = '5';
-
-		for (unsigned int i = 0U; i < 5U; i++)
-			data[i + offset + 1U] = refl->m_id.at(i);
-
-		for (unsigned int i = 0U; i < 16U; i++)
-			data[i + offset + 6U] = std::toupper(refl->m_name.at(i));
-
-		for (unsigned int i = 0U; i < 3U; i++)
-			data[i + offset + 22U] = refl->m_count.at(i);
-
-		for (unsigned int i = 0U; i < 10U; i++)
-			data[i + offset + 25U] = ' ';
-
-		for (unsigned int i = 0U; i < 14U; i++)
-			data[i + offset + 35U] = refl->m_desc.at(i);
-
-		data[offset + 49U] = 0x0DU;
-	}
+	for (unsigned int j = 0U; j < n; j++, offset += 50U)
+		writeEntry(data + offset, '5', curr->at(j + m_start));
 
 	unsigned int k = 1029U - offset;
 	for(unsigned int i = 0U; i < k; i++)
@@ -927,9 +999,9 @@ void CWiresX::sendAllReply()
 	data[offset + 0U] = 0x03U;			// End of data marker
 	data[offset + 1U] = CCRC::addCRC(data, offset + 1U);
 
-	CUtils::dump(1U, "ALL Reply", data, offset + 2U);
+	page = addPage(key, data, offset + 2U);
 
-	createReply(data, offset + 2U);
+	sendPage(*page, "ALL Reply");
 
 	m_seqNo++;
 }
@@ -941,7 +1013,16 @@ void CWiresX::sendSearchReply()
 		return;
 	}
 
-	std::vector<CYSFReflector*>& search = m_reflectors.search(m_search);
+	std::string key = "SEARCH/" + m_search + "/" + std::to_string(m_start);
+
+	const CWiresXPage* page = findPage(m_reflectors.current(), key);
+	if (page != nullptr) {
+		sendPage(*page, "SEARCH Reply");
+		m_seqNo++;
+		return;
+	}
+
+	std::vector<const CYSFReflector*>& search = m_reflectors.search(m_search);
 	if (search.size() == 0U) {
 		sendSearchNotFoundReply();
 		return;
@@ -950,7 +1031,8 @@ void CWiresX::sendSearchReply()
 	unsigned char data[1100U];
 	::memset(data, 0x00U, 1100U);
 
-	data[0U] = m_seqNo;
+	// The sequence number is added when the page is sent
+	data[0U] = 0x00U;
 
 	for (unsigned int i = 0U; i < 4U; i++)
 		data[i + 1U] = ALL_RESP[i];
@@ -977,30 +1059,8 @@ void CWiresX::sendSearchReply()
 	data[28U] = 0x0DU;
 
 	unsigned int offset = 29U;
-	for (unsigned int j = 0U; j < n; j++, offset += 50U) {
-		CYSFReflector* refl = search.at(j + m_start);
-
-		::memset(data + offset, ' ', 50U);
-
-		data[offset + 0U] = '1';
-
-		for (unsigned int i = 0U; i < 5U; i++)
-			data[i + offset + 1U] = refl->m_id.at(i);
-
-		for (unsigned int i = 0U; i < 16U; i++)
-			data[i + offset + 6U] = std::toupper(refl->m_name.at(i));
-
-		for (unsigned int i = 0U; i < 3U; i++)
-			data[i + offset + 22U] = refl->m_count.at(i);
-
-		for (unsigned int i = 0U; i < 10U; i++)
-			data[i + offset + 25U] = ' ';
-
-		for (unsigned int i = 0U; i < 14U; i++)
-			data[i + offset + 35U] = refl->m_desc.at(i);
-
-		data[offset + 49U] = 0x0DU;
-	}
+	for (unsigned int j = 0U; j < n; j++, offset += 50U)
+		writeEntry(data + offset, '1', search.at(j + m_start));
 
 	unsigned int k = 1029U - offset;
 	for (unsigned int i = 0U; i < k; i++) {
@@ -1015,9 +1075,9 @@ void CWiresX::sendSearchReply()
 	data[offset + 0U] = 0x03U;			// End of data marker
 	data[offset + 1U] = CCRC::addCRC(data, offset + 1U);
 
-	CUtils::dump(1U, "SEARCH Reply", data, offset + 2U);
+	page = addPage(key, data, offset + 2U);
 
-	createReply(data, offset + 2U);
+	sendPage(*page, "SEARCH Reply");
 
 	m_seqNo++;
 }
@@ -1088,30 +1148,8 @@ void CWiresX::sendCategoryReply()
 	data[28U] = 0x0DU;
 
 	unsigned int offset = 29U;
-	for (unsigned int j = 0U; j < n; j++, offset += 50U) {
-		CYSFReflector* refl = m_category.at(j);
-
-		::memset(data + offset, ' ', 50U);
-
-		data[offset + 0U] = '5';
-
-		for (unsigned int i = 0U; i < 5U; i++)
-			data[i + offset + 1U] = refl->m_id.at(i);
-
-		for (unsigned int i = 0U; i < 16U; i++)
-			data[i + offset + 6U] = std::toupper(refl->m_name.at(i));
-
-		for (unsigned int i = 0U; i < 3U; i++)
-			data[i + offset + 22U] = refl->m_count.at(i);
-
-		for (unsigned int i = 0U; i < 10U; i++)
-			data[i + offset + 25U] = ' ';
-
-		for (unsigned int i = 0U; i < 14U; i++)
-			data[i + offset + 35U] = refl->m_desc.at(i);
-
-		data[offset + 49U] = 0x0DU;
-	}
+	for (unsigned int j = 0U; j < n; j++, offset += 50U)
+		writeEntry(data + offset, '5', m_category.at(j));
 
 	unsigned int k = 1029U - offset;
 	for (unsigned int i = 0U; i < k; i++) {
@@ -1133,6 +1171,21 @@ void CWiresX::sendCategoryReply()
 	m_seqNo++;
 }
 
+void CWiresX::writeEntry(unsigned char* data, char type, const CYSFReflector* refl) const
+{
+	assert(data != nullptr);
+	assert(refl != nullptr);
+
+	// The reflector text is already upper case and padded to these widths
+	data[0U] = type;
+	::memcpy(data + 1U,  refl->m_id,    YSF_REFLECTOR_ID_LENGTH);
+	::memcpy(data + 6U,  refl->m_name,  YSF_REFLECTOR_NAME_LENGTH);
+	::memcpy(data + 22U, refl->m_count, YSF_REFLECTOR_COUNT_LENGTH);
+	::memset(data + 25U, ' ', 10U);
+	::memcpy(data + 35U, refl->m_desc,  YSF_REFLECTOR_DESC_LENGTH);
+	data[49U] = 0x0DU;
+}
+
 bool CWiresX::isBusy() const
 {
 	return m_busy;
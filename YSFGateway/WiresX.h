@@ -21,12 +21,16 @@
 
 #include "YSFReflectors.h"
 #include "YSFNetwork.h"
+#include "YSFPayload.h"
+#include "YSFFrameView.h"
 #include "YSFFICH.h"
 #include "Timer.h"
 #include "StopWatch.h"
 #include "RingBuffer.h"
 
+#include <unordered_map>
 #include <string>
+#include <vector>
 
 enum class WX_STATUS {
 	NONE,
@@ -46,6 +50,16 @@ enum class WXSI_STATUS {
 	CATEGORY
 };
 
+// An ALL or SEARCH reply page already encoded into its frames. It is held
+// with a sequence number of zero, only the frames carrying the sequence
+// number and the checksum are encoded again when it is sent.
+struct CWiresXPage {
+	unsigned int               m_length;
+	std::vector<unsigned char> m_data;
+	std::vector<unsigned char> m_frames;
+	std::vector<unsigned int>  m_offsets;
+};
+
 class CWiresX {
 public:
 	CWiresX(const std::string& callsign, const std::string& suffix, CYSFNetwork* network, CYSFReflectors& reflectors);
@@ -61,12 +75,12 @@ public:
 	bool start();
 	bool isBusy() const;
 
-	WX_STATUS process(const unsigned char* data, const unsigned char* source, const CYSFFICH& fich, bool wiresXCommandPassthrough);
+	WX_STATUS process(CYSFFrameView& frame, bool wiresXCommandPassthrough);
 
-	CYSFReflector* getReflector() const;
-	void setReflector(CYSFReflector* reflector);
+	const CYSFReflector* getReflector() const;
+	void setReflector(const CYSFReflector* reflector);
 
-	void processConnect(CYSFReflector* reflector);
+	void processConnect(const CYSFReflector* reflector);
 	void processDisconnect(const unsigned char* source = nullptr);
 
 	void sendConnect(CYSFNetwork* network);
@@ -78,22 +92,26 @@ private:
 	std::string     m_node;
 	CYSFNetwork*    m_network;
 	CYSFReflectors& m_reflectors;
-	CYSFReflector*  m_reflector;
+	const CYSFReflector* m_reflector;
+	std::shared_ptr<const CYSFReflectorList> m_reflectorList;
 	std::string     m_id;
 	std::string     m_name;
-	unsigned char*  m_command;
+	unsigned char   m_command[300U];
 	unsigned int    m_txFrequency;
 	unsigned int    m_rxFrequency;
 	CTimer          m_timer;
 	unsigned char   m_seqNo;
-	unsigned char*  m_header;
-	unsigned char*  m_csd1;
-	unsigned char*  m_csd2;
-	unsigned char*  m_csd3;
+	unsigned char   m_header[34U];
+	unsigned char   m_csd1[20U];
+	unsigned char   m_csd2[20U];
+	unsigned char   m_csd3[20U];
 	WXSI_STATUS     m_status;
 	unsigned int    m_start;
 	std::string     m_search;
-	std::vector<CYSFReflector*> m_category;
+	std::vector<const CYSFReflector*> m_category;
+	std::shared_ptr<const CYSFReflectorList> m_categoryList;
+	std::unordered_map<std::string, CWiresXPage> m_pages;
+	std::shared_ptr<const CYSFReflectorList> m_pageList;
 	bool            m_busy;
 	CTimer          m_busyTimer;
 	CStopWatch      m_txWatch;
@@ -113,7 +131,15 @@ private:
 	void sendSearchNotFoundReply();
 	void sendCategoryReply();
 
+	void writeEntry(unsigned char* data, char type, const CYSFReflector* refl) const;
+
 	void createReply(const unsigned char* data, unsigned int length, CYSFNetwork* network = nullptr);
+	void encodeReply(const unsigned char* data, unsigned int length, std::vector<unsigned char>& frames, std::vector<unsigned int>& offsets) const;
+	unsigned int writePayload(CYSFPayload& payload, unsigned char fn, unsigned char bn, const unsigned char* data, unsigned int offset, unsigned char* buffer) const;
+
+	const CWiresXPage* findPage(const std::shared_ptr<const CYSFReflectorList>& list, const std::string& key);
+	const CWiresXPage* addPage(const std::string& key, const unsigned char* data, unsigned int length);
+	void sendPage(const CWiresXPage& page, const char* title);
 	void writeData(const unsigned char* data, CYSFNetwork* network, bool sendWiresXtoNetwork);
 	unsigned char calculateFT(unsigned int length, unsigned int offset) const;
 };
@@ -22,37 +22,92 @@
 #include <cassert>
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define	USE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define	USE_NEON
+#include <arm_neon.h>
+#endif
+
 const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
 
 #define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
 #define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
 
-const uint8_t BRANCH_TABLE1[] = {0U, 0U, 0U, 0U, 1U, 1U, 1U, 1U};
-const uint8_t BRANCH_TABLE2[] = {0U, 1U, 1U, 0U, 0U, 1U, 1U, 0U};
+// The generator polynomials, 1 + D^3 + D^4 and 1 + D + D^2 + D^4, with the
+// coefficient of D^n in bit n
+const unsigned int G1 = 0x19U;
+const unsigned int G2 = 0x17U;
+
+static constexpr uint8_t parity(unsigned int value)
+{
+	uint8_t p = 0U;
+	while (value != 0U) {
+		p ^= value & 1U;
+		value >>= 1;
+	}
+
+	return p;
+}
+
+// The tables are worked out by the compiler from the generator polynomials.
+// The branch metrics are for the lower eight states, indexed by (s0 << 1) | s1.
+// The encoder output is for four input bits, indexed by those bits in the low
+// nibble and the four bits before them in the high nibble.
+struct CConvolutionTables {
+	alignas(16) uint16_t m_branch[4U][8U];
+	uint8_t              m_encode[256U];
+
+	constexpr CConvolutionTables() :
+	m_branch(),
+	m_encode()
+	{
+		// A zero entering state i, whose oldest bit is always zero
+		for (unsigned int s = 0U; s < 4U; s++) {
+			for (unsigned int i = 0U; i < 8U; i++) {
+				uint8_t g1 = parity((i << 1) & G1);
+				uint8_t g2 = parity((i << 1) & G2);
+				m_branch[s][i] = uint16_t((g1 ^ (s >> 1)) + (g2 ^ (s & 1U)));
+			}
+		}
+
+		for (unsigned int n = 0U; n < 256U; n++) {
+			uint8_t out = 0U;
+			for (unsigned int i = 0U; i < 4U; i++) {
+				// The newest bit in bit 0 and the four before it above
+				unsigned int reg = (n >> (3U - i)) & 0x1FU;
+				out = uint8_t((out << 2) | (parity(reg & G1) << 1) | parity(reg & G2));
+			}
+
+			m_encode[n] = out;
+		}
+	}
+};
+
+static constexpr CConvolutionTables TABLES;
+
+#if defined(USE_NEON)
+alignas(16) const uint16_t DECISION_BITS[8U] = {0x01U, 0x02U, 0x04U, 0x08U, 0x10U, 0x20U, 0x40U, 0x80U};
+#endif
 
 const unsigned int NUM_OF_STATES_D2 = 8U;
 const unsigned int NUM_OF_STATES = 16U;
-const uint32_t     M = 2U;
+const uint16_t     M = 2U;
 const unsigned int K = 5U;
 
 CYSFConvolution::CYSFConvolution() :
-m_metrics1(nullptr),
-m_metrics2(nullptr),
+m_metrics1(),
+m_metrics2(),
 m_oldMetrics(nullptr),
 m_newMetrics(nullptr),
-m_decisions(nullptr),
+m_decisions(),
 m_dp(nullptr)
 {
-	m_metrics1  = new uint16_t[16U];
-	m_metrics2  = new uint16_t[16U];
-	m_decisions = new uint64_t[180U];
 }
 
 CYSFConvolution::~CYSFConvolution()
 {
-	delete[] m_metrics1;
-	delete[] m_metrics2;
-	delete[] m_decisions;
 }
 
 void CYSFConvolution::start()
@@ -65,35 +120,92 @@ void CYSFConvolution::start()
 	m_dp = m_decisions;
 }
 
+// One add-compare-select step over all sixteen states. State i of the lower
+// half and state i + 8 of the upper half both lead to new states 2i and
+// 2i + 1, so the eight pairs are done side by side. Metrics grow by at most
+// M per step and so never get near overflowing 16 bits in 180 steps.
 void CYSFConvolution::decode(uint8_t s0, uint8_t s1)
 {
-  *m_dp = 0U;
+	assert(s0 <= 1U);
+	assert(s1 <= 1U);
+	assert((m_dp - m_decisions) < 180);
+
+	const uint16_t* branch = TABLES.m_branch[(s0 << 1) | s1];
+
+#if defined(USE_SSE2)
+	const __m128i bm  = _mm_load_si128((const __m128i*)branch);
+	const __m128i bmc = _mm_sub_epi16(_mm_set1_epi16(M), bm);
+
+	const __m128i lower = _mm_loadu_si128((const __m128i*)(m_oldMetrics + 0U));
+	const __m128i upper = _mm_loadu_si128((const __m128i*)(m_oldMetrics + NUM_OF_STATES_D2));
+
+	const __m128i m00 = _mm_add_epi16(lower, bm);
+	const __m128i m01 = _mm_add_epi16(upper, bmc);
+	const __m128i m10 = _mm_add_epi16(lower, bmc);
+	const __m128i m11 = _mm_add_epi16(upper, bm);
 
-  for (uint8_t i = 0U; i < NUM_OF_STATES_D2; i++) {
-    uint8_t j = i * 2U;
+	const __m128i new0 = _mm_min_epi16(m00, m01);
+	const __m128i new1 = _mm_min_epi16(m10, m11);
 
-    uint16_t metric = (BRANCH_TABLE1[i] ^ s0) + (BRANCH_TABLE2[i] ^ s1);
+	// The decision is set when the upper path survives, including on a tie
+	const __m128i decision0 = _mm_cmpeq_epi16(new0, m01);
+	const __m128i decision1 = _mm_cmpeq_epi16(new1, m11);
 
-    uint16_t m0 = m_oldMetrics[i] + metric;
-    uint16_t m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + (M - metric);
-    uint8_t decision0 = (m0 >= m1) ? 1U : 0U;
-    m_newMetrics[j + 0U] = decision0 != 0U ? m1 : m0;
+	_mm_storeu_si128((__m128i*)(m_newMetrics + 0U),                _mm_unpacklo_epi16(new0, new1));
+	_mm_storeu_si128((__m128i*)(m_newMetrics + NUM_OF_STATES_D2), _mm_unpackhi_epi16(new0, new1));
 
-    m0 = m_oldMetrics[i] + (M - metric);
-    m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + metric;
-    uint8_t decision1 = (m0 >= m1) ? 1U : 0U;
-    m_newMetrics[j + 1U] = decision1 != 0U ? m1 : m0;
+	const __m128i decisions = _mm_packs_epi16(_mm_unpacklo_epi16(decision0, decision1), _mm_unpackhi_epi16(decision0, decision1));
+	*m_dp = uint16_t(_mm_movemask_epi8(decisions));
+#elif defined(USE_NEON)
+	const uint16x8_t bm  = vld1q_u16(branch);
+	const uint16x8_t bmc = vsubq_u16(vdupq_n_u16(M), bm);
 
-    *m_dp |= (uint64_t(decision1) << (j + 1U)) | (uint64_t(decision0) << (j + 0U));
-  }
+	const uint16x8_t lower = vld1q_u16(m_oldMetrics + 0U);
+	const uint16x8_t upper = vld1q_u16(m_oldMetrics + NUM_OF_STATES_D2);
 
-  ++m_dp;
+	const uint16x8_t m00 = vaddq_u16(lower, bm);
+	const uint16x8_t m01 = vaddq_u16(upper, bmc);
+	const uint16x8_t m10 = vaddq_u16(lower, bmc);
+	const uint16x8_t m11 = vaddq_u16(upper, bm);
 
-  assert((m_dp - m_decisions) <= 180);
+	const uint16x8x2_t metrics = vzipq_u16(vminq_u16(m00, m01), vminq_u16(m10, m11));
+	vst1q_u16(m_newMetrics + 0U,                metrics.val[0]);
+	vst1q_u16(m_newMetrics + NUM_OF_STATES_D2, metrics.val[1]);
 
-  uint16_t* tmp = m_oldMetrics;
-  m_oldMetrics = m_newMetrics;
-  m_newMetrics = tmp;
+	// The decision is set when the upper path survives, including on a tie
+	const uint16x8x2_t decisions = vzipq_u16(vcgeq_u16(m00, m01), vcgeq_u16(m10, m11));
+
+	const uint16x8_t bits = vld1q_u16(DECISION_BITS);
+	const uint64x2_t lower64 = vpaddlq_u32(vpaddlq_u16(vandq_u16(decisions.val[0], bits)));
+	const uint64x2_t upper64 = vpaddlq_u32(vpaddlq_u16(vandq_u16(decisions.val[1], bits)));
+	*m_dp = uint16_t(vgetq_lane_u64(lower64, 0) + vgetq_lane_u64(lower64, 1)) | uint16_t((vgetq_lane_u64(upper64, 0) + vgetq_lane_u64(upper64, 1)) << 8);
+#else
+	uint32_t decisions = 0U;
+
+	for (unsigned int i = 0U; i < NUM_OF_STATES_D2; i++) {
+		unsigned int j = i * 2U;
+
+		uint16_t m0 = m_oldMetrics[i] + branch[i];
+		uint16_t m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + (M - branch[i]);
+		uint32_t decision0 = (m0 >= m1) ? 1U : 0U;
+		m_newMetrics[j + 0U] = decision0 != 0U ? m1 : m0;
+
+		m0 = m_oldMetrics[i] + (M - branch[i]);
+		m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + branch[i];
+		uint32_t decision1 = (m0 >= m1) ? 1U : 0U;
+		m_newMetrics[j + 1U] = decision1 != 0U ? m1 : m0;
+
+		decisions |= (decision1 << (j + 1U)) | (decision0 << (j + 0U));
+	}
+
+	*m_dp = uint16_t(decisions);
+#endif
+
+	++m_dp;
+
+	uint16_t* tmp = m_oldMetrics;
+	m_oldMetrics = m_newMetrics;
+	m_newMetrics = tmp;
 }
 
 void CYSFConvolution::chainback(unsigned char* out, unsigned int nBits)
@@ -113,15 +225,38 @@ void CYSFConvolution::chainback(unsigned char* out, unsigned int nBits)
 	}
 }
 
+// The metric of the path that chainback() follows, which is the number of
+// received bits that differ from its encoding
+uint16_t CYSFConvolution::getMetric() const
+{
+	return m_oldMetrics[0U];
+}
+
 void CYSFConvolution::encode(const unsigned char* in, unsigned char* out, unsigned int nBits) const
 {
 	assert(in != nullptr);
 	assert(out != nullptr);
 	assert(nBits > 0U);
 
-	uint8_t d1 = 0U, d2 = 0U, d3 = 0U, d4 = 0U;
-	uint32_t k = 0U;
-	for (unsigned int i = 0U; i < nBits; i++) {
+	// Each input byte gives exactly two output bytes
+	uint8_t prev = 0U;
+	unsigned int nBytes = nBits / 8U;
+	for (unsigned int i = 0U; i < nBytes; i++) {
+		uint8_t b = in[i];
+
+		out[i * 2U + 0U] = TABLES.m_encode[uint8_t((prev << 4) | (b >> 4))];
+		out[i * 2U + 1U] = TABLES.m_encode[b];
+
+		prev = b;
+	}
+
+	// Any bits left over go through one at a time
+	uint8_t d1 = (prev >> 0) & 1U;
+	uint8_t d2 = (prev >> 1) & 1U;
+	uint8_t d3 = (prev >> 2) & 1U;
+	uint8_t d4 = (prev >> 3) & 1U;
+	uint32_t k = nBytes * 16U;
+	for (unsigned int i = nBytes * 8U; i < nBits; i++) {
 		uint8_t d = READ_BIT1(in, i) ? 1U : 0U;
 
 		uint8_t g1 = (d + d3 + d4) & 1;
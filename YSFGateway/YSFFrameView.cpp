@@ -0,0 +1,136 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "YSFFrameView.h"
+#include "YSFDefines.h"
+
+#include <cassert>
+#include <cstring>
+
+CYSFFrameView::CYSFFrameView(const unsigned char* buffer) :
+m_buffer(buffer),
+m_payload(),
+m_fich(),
+m_fichDecoded(false),
+m_fichValid(false),
+m_dch(),
+m_dchDecoded(),
+m_dchValid()
+{
+	assert(buffer != nullptr);
+}
+
+CYSFFrameView::~CYSFFrameView()
+{
+}
+
+const unsigned char* CYSFFrameView::getBuffer() const
+{
+	return m_buffer;
+}
+
+const unsigned char* CYSFFrameView::getSource() const
+{
+	return m_buffer + 14U;
+}
+
+const unsigned char* CYSFFrameView::getData() const
+{
+	return m_buffer + 35U;
+}
+
+bool CYSFFrameView::decodeFICH()
+{
+	if (!m_fichDecoded) {
+		m_fichValid   = m_fich.decode(getData());
+		m_fichDecoded = true;
+	}
+
+	return m_fichValid;
+}
+
+const CYSFFICH& CYSFFrameView::getFICH() const
+{
+	assert(m_fichDecoded);
+
+	return m_fich;
+}
+
+bool CYSFFrameView::readVDMode1Data(unsigned char* dt)
+{
+	assert(dt != nullptr);
+
+	if (!m_dchDecoded[DCH_DATA1]) {
+		m_dchValid[DCH_DATA1]   = m_payload.readVDMode1Data(getData(), m_dch[DCH_DATA1]);
+		m_dchDecoded[DCH_DATA1] = true;
+	}
+
+	if (m_dchValid[DCH_DATA1])
+		::memcpy(dt, m_dch[DCH_DATA1], 20U);
+
+	return m_dchValid[DCH_DATA1];
+}
+
+bool CYSFFrameView::readVDMode2Data(unsigned char* dt)
+{
+	assert(dt != nullptr);
+
+	if (!m_dchDecoded[DCH_VD2]) {
+		m_dchValid[DCH_VD2]   = m_payload.readVDMode2Data(getData(), m_dch[DCH_VD2]);
+		m_dchDecoded[DCH_VD2] = true;
+	}
+
+	if (m_dchValid[DCH_VD2])
+		::memcpy(dt, m_dch[DCH_VD2], YSF_CALLSIGN_LENGTH);
+
+	return m_dchValid[DCH_VD2];
+}
+
+bool CYSFFrameView::readDataFRModeData1(unsigned char* dt)
+{
+	assert(dt != nullptr);
+
+	::memset(dt, ' ', 20U);
+
+	if (!m_dchDecoded[DCH_DATA1]) {
+		m_dchValid[DCH_DATA1]   = m_payload.readDataFRModeData1(getData(), m_dch[DCH_DATA1]);
+		m_dchDecoded[DCH_DATA1] = true;
+	}
+
+	if (m_dchValid[DCH_DATA1])
+		::memcpy(dt, m_dch[DCH_DATA1], 20U);
+
+	return m_dchValid[DCH_DATA1];
+}
+
+bool CYSFFrameView::readDataFRModeData2(unsigned char* dt)
+{
+	assert(dt != nullptr);
+
+	::memset(dt, ' ', 20U);
+
+	if (!m_dchDecoded[DCH_DATA2]) {
+		m_dchValid[DCH_DATA2]   = m_payload.readDataFRModeData2(getData(), m_dch[DCH_DATA2]);
+		m_dchDecoded[DCH_DATA2] = true;
+	}
+
+	if (m_dchValid[DCH_DATA2])
+		::memcpy(dt, m_dch[DCH_DATA2], 20U);
+
+	return m_dchValid[DCH_DATA2];
+}
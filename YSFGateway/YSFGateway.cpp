@@ -20,8 +20,9 @@
 #include "MQTTConnection.h"
 #include "UDPSocket.h"
 #include "StopWatch.h"
+#include "EventLoop.h"
 #include "Version.h"
-#include "YSFFICH.h"
+#include "YSFFrameView.h"
 #include "Thread.h"
 #include "Timer.h"
 #include "Utils.h"
@@ -44,6 +45,13 @@ const char* DEFAULT_INI_FILE = "YSFGateway.ini";
 const char* DEFAULT_INI_FILE = "/etc/YSFGateway.ini";
 #endif
 
+// The longest the main loop will sleep when no network traffic is waiting
+const unsigned int EVENT_LOOP_TICK = 10U;
+
+// Host name lookups run on their own threads, answers are kept for an hour
+const unsigned int DNS_THREADS   = 2U;
+const unsigned int DNS_CACHE_TTL = 3600U;
+
 // In Log.cpp
 extern CMQTTConnection* m_mqtt;
 
@@ -133,11 +141,13 @@ m_suffix(),
 m_conf(configFile),
 m_writer(nullptr),
 m_gps(nullptr),
+m_resolver(nullptr),
 m_reflectors(nullptr),
 m_wiresX(nullptr),
 m_dtmf(),
 m_ysfNetwork(nullptr),
 m_fcsNetwork(nullptr),
+m_rptNetwork(nullptr),
 m_linkType(LINK_TYPE::NONE),
 m_current(),
 m_startup(),
@@ -145,7 +155,10 @@ m_options(),
 m_exclude(false),
 m_inactivityTimer(1000U),
 m_lostTimer(1000U, 120U),
-m_fcsNetworkEnabled(false)
+m_fcsNetworkEnabled(false),
+m_revert(false),
+m_reconnect(false),
+m_wiresXCommandPassthrough(false)
 {
 	CUDPSocket::startup();
 }
@@ -157,11 +170,9 @@ CYSFGateway::~CYSFGateway()
 
 int CYSFGateway::run()
 {
-	bool ret = m_conf.read();
-	if (!ret) {
-		::fprintf(stderr, "YSFGateway: cannot read the .ini file\n");
+	bool ret = readConfig();
+	if (!ret)
 		return 1;
-	}
 
 	setlocale(LC_ALL, "C");
 
@@ -238,6 +249,53 @@ int CYSFGateway::run()
 	if (!ret)
 		return 1;
 
+	ret = open();
+	if (!ret)
+		return 1;
+
+	CStopWatch stopWatch;
+	stopWatch.start();
+
+	LogInfo("YSFGateway-%s is starting", VERSION);
+	LogInfo("Built %s %s (GitID #%.7s)", __TIME__, __DATE__, gitversion);
+
+	writeJSONStatus("YSFGateway is starting");
+
+	CEventLoop eventLoop(EVENT_LOOP_TICK);
+	eventLoop.addSocket(m_rptNetwork->getSocket());
+	if (m_ysfNetwork != nullptr)
+		eventLoop.addSocket(m_ysfNetwork->getSocket());
+	if (m_fcsNetwork != nullptr)
+		eventLoop.addSocket(m_fcsNetwork->getSocket());
+
+	while (!m_killed) {
+		eventLoop.wait();
+
+		unsigned int ms = stopWatch.elapsed();
+		stopWatch.start();
+
+		clock(ms);
+	}
+
+	LogInfo("YSFGateway is stopping");
+	writeJSONStatus("YSFGateway is stopping");
+
+	close();
+
+	return 0;
+}
+
+bool CYSFGateway::readConfig()
+{
+	bool ret = m_conf.read();
+	if (!ret)
+		::fprintf(stderr, "YSFGateway: cannot read the .ini file\n");
+
+	return ret;
+}
+
+bool CYSFGateway::open()
+{
 	m_callsign = m_conf.getCallsign();
 	m_suffix   = m_conf.getSuffix();
 
@@ -246,23 +304,35 @@ int CYSFGateway::run()
 	unsigned int rptAddrLen;
 	if (CUDPSocket::lookup(m_conf.getRptAddress(), m_conf.getRptPort(), rptAddr, rptAddrLen) != 0) {
 		::LogError("Cannot find the address of the MMDVM Host");
-		return 1;
+		return false;
 	}
 
 	std::string myAddress = m_conf.getMyAddress();
 	unsigned short myPort = m_conf.getMyPort();
-	CYSFNetwork rptNetwork(myAddress, myPort, m_callsign, debug);
+	m_rptNetwork = new CYSFNetwork(myAddress, myPort, m_callsign, debug);
+
+	unsigned int receiveBudget = m_conf.getNetworkReceiveBudget();
+	if (receiveBudget == 0U)
+		receiveBudget = 1U;
 
-	ret = rptNetwork.setDestination("MMDVM", rptAddr, rptAddrLen);
+	m_rptNetwork->setReceiveBudget(receiveBudget);
+
+	bool ret = m_rptNetwork->setDestination("MMDVM", rptAddr, rptAddrLen);
 	if (!ret) {
 		::LogError("Cannot open the repeater network port");
-		return 1;
+		return false;
 	}
 
+	m_resolver = new CDNSResolver(DNS_THREADS, DNS_CACHE_TTL);
+	ret = m_resolver->start();
+	if (!ret)
+		return false;
+
 	bool ysfNetworkEnabled = m_conf.getYSFNetworkEnabled();
 	if (ysfNetworkEnabled) {
 		unsigned short ysfPort = m_conf.getYSFNetworkPort();
 		m_ysfNetwork = new CYSFNetwork(ysfPort, m_callsign, debug);
+		m_ysfNetwork->setReceiveBudget(receiveBudget);
 	}
 
 	m_fcsNetworkEnabled = m_conf.getFCSNetworkEnabled();
@@ -274,11 +344,12 @@ int CYSFGateway::run()
 
 		unsigned short fcsPort = m_conf.getFCSNetworkPort();
 
-		m_fcsNetwork = new CFCSNetwork(fcsPort, m_callsign, rxFrequency, txFrequency, locator, id, debug);
+		m_fcsNetwork = new CFCSNetwork(fcsPort, m_callsign, rxFrequency, txFrequency, locator, id, *m_resolver, debug);
+		m_fcsNetwork->setReceiveBudget(receiveBudget);
 		ret = m_fcsNetwork->open();
 		if (!ret) {
 			::LogError("Cannot open the FCS reflector network port");
-			return 1;
+			return false;
 		}
 	}
 
@@ -287,167 +358,164 @@ int CYSFGateway::run()
 	std::string fileName = m_conf.getYSFNetworkHosts();
 	unsigned int reloadTime = m_conf.getYSFNetworkReloadTime();
 
-	m_reflectors = new CYSFReflectors(fileName, reloadTime);
+	m_reflectors = new CYSFReflectors(fileName, reloadTime, *m_resolver);
 	m_reflectors->reload();
 
-	createWiresX(&rptNetwork);
+	ret = m_reflectors->run();
+	if (!ret) {
+		::LogError("Cannot start the YSF reflector loader");
+		return false;
+	}
+
+	createWiresX(m_rptNetwork);
 
 	createGPS();
 
 	m_startup   = m_conf.getNetworkStartup();
 	m_options   = m_conf.getNetworkOptions();
-	bool revert = m_conf.getNetworkRevert();
-	bool reconnect = m_conf.getNetworkReconnect();
-	bool wiresXCommandPassthrough = m_conf.getWiresXCommandPassthrough();
+	m_revert    = m_conf.getNetworkRevert();
+	m_reconnect = m_conf.getNetworkReconnect();
+	m_wiresXCommandPassthrough = m_conf.getWiresXCommandPassthrough();
 
 	startupLinking("startup");
 
-	CStopWatch stopWatch;
-	stopWatch.start();
-
-	LogInfo("YSFGateway-%s is starting", VERSION);
-	LogInfo("Built %s %s (GitID #%.7s)", __TIME__, __DATE__, gitversion);
-
-	writeJSONStatus("YSFGateway is starting");
-
-	while (!m_killed) {
-		unsigned char buffer[200U];
-		memset(buffer, 0U, 200U);
-
-		while (rptNetwork.read(buffer) > 0U) {
-			CYSFFICH fich;
-			bool valid = fich.decode(buffer + 35U);
-			m_exclude = false;
-			if (valid) {
-				unsigned char dt = fich.getDT();
-
-				CYSFReflector* reflector = m_wiresX->getReflector();
-				if (m_ysfNetwork != nullptr && m_linkType == LINK_TYPE::YSF && wiresXCommandPassthrough && reflector != nullptr && reflector->m_wiresX) {
-					processDTMF(buffer, dt);
-					processWiresX(buffer, fich, reflector->m_wiresX, wiresXCommandPassthrough); // Honour reflector->m_wiresX status
-				} else {
-					processDTMF(buffer, dt);
-					processWiresX(buffer, fich, false, wiresXCommandPassthrough); // Remove the assumption that wiresXCommandPassthrough is set
-					reflector = m_wiresX->getReflector(); // reflector may have changed
-					if (m_ysfNetwork != nullptr && m_linkType == LINK_TYPE::YSF && reflector != nullptr && reflector->m_wiresX)
-						m_exclude = (dt == YSF_DT_DATA_FR_MODE);
-				}
+	return true;
+}
 
-				if (m_gps != nullptr)
-					m_gps->data(buffer + 14U, buffer + 35U, fich);
+void CYSFGateway::clock(unsigned int ms)
+{
+	m_resolver->clock();
+
+	m_rptNetwork->clock(ms);
+	if (m_ysfNetwork != nullptr)
+		m_ysfNetwork->clock(ms);
+	if (m_fcsNetwork != nullptr)
+		m_fcsNetwork->clock(ms);
+	if (m_writer != nullptr)
+		m_writer->clock(ms);
+	m_wiresX->clock(ms);
+
+	unsigned char buffer[200U];
+	memset(buffer, 0U, 200U);
+
+	while (m_rptNetwork->read(buffer) > 0U) {
+		CYSFFrameView frame(buffer);
+		bool valid = frame.decodeFICH();
+		m_exclude = false;
+		if (valid) {
+			unsigned char dt = frame.getFICH().getDT();
+
+			const CYSFReflector* reflector = m_wiresX->getReflector();
+			if (m_ysfNetwork != nullptr && m_linkType == LINK_TYPE::YSF && m_wiresXCommandPassthrough && reflector != nullptr && reflector->m_wiresX) {
+				processDTMF(buffer, dt);
+				processWiresX(frame, reflector->m_wiresX, m_wiresXCommandPassthrough); // Honour reflector->m_wiresX status
+			} else {
+				processDTMF(buffer, dt);
+				processWiresX(frame, false, m_wiresXCommandPassthrough); // Remove the assumption that wiresXCommandPassthrough is set
+				reflector = m_wiresX->getReflector(); // reflector may have changed
+				if (m_ysfNetwork != nullptr && m_linkType == LINK_TYPE::YSF && reflector != nullptr && reflector->m_wiresX)
+					m_exclude = (dt == YSF_DT_DATA_FR_MODE);
 			}
 
-			if (m_ysfNetwork != nullptr && m_linkType == LINK_TYPE::YSF && !m_exclude) {
-				if (::memcmp(buffer + 0U, "YSFD", 4U) == 0) {
-					m_ysfNetwork->write(buffer);
-					m_inactivityTimer.start();
-				}
-			}
+			if (m_gps != nullptr)
+				m_gps->data(frame);
+		}
 
-			if (m_fcsNetwork != nullptr && m_linkType == LINK_TYPE::FCS && !m_exclude) {
-				if (::memcmp(buffer + 0U, "YSFD", 4U) == 0) {
-					m_fcsNetwork->write(buffer);
-					m_inactivityTimer.start();
-				}
+		if (m_ysfNetwork != nullptr && m_linkType == LINK_TYPE::YSF && !m_exclude) {
+			if (::memcmp(buffer + 0U, "YSFD", 4U) == 0) {
+				m_ysfNetwork->write(buffer);
+				m_inactivityTimer.start();
 			}
+		}
 
-			if ((buffer[34U] & 0x01U) == 0x01U) {
-				if (m_gps != nullptr)
-					m_gps->reset();
-				m_dtmf.reset();
-				m_exclude = false;
+		if (m_fcsNetwork != nullptr && m_linkType == LINK_TYPE::FCS && !m_exclude) {
+			if (::memcmp(buffer + 0U, "YSFD", 4U) == 0) {
+				m_fcsNetwork->write(buffer);
+				m_inactivityTimer.start();
 			}
 		}
 
-		if (m_ysfNetwork != nullptr) {
-			while (m_ysfNetwork->read(buffer) > 0U) {
-				if (m_linkType == LINK_TYPE::YSF) {
-					// Only pass through YSF data packets
-					if (::memcmp(buffer + 0U, "YSFD", 4U) == 0 && !m_wiresX->isBusy())
-						rptNetwork.write(buffer);
-
-					m_lostTimer.start();
-				}
-			}
+		if ((buffer[34U] & 0x01U) == 0x01U) {
+			if (m_gps != nullptr)
+				m_gps->reset();
+			m_dtmf.reset();
+			m_exclude = false;
 		}
+	}
 
-		if (m_fcsNetwork != nullptr) {
-			while (m_fcsNetwork->read(buffer) > 0U) {
-				if (m_linkType == LINK_TYPE::FCS) {
-					// Only pass through YSF data packets
-					if (::memcmp(buffer + 0U, "YSFD", 4U) == 0 && !m_wiresX->isBusy())
-						rptNetwork.write(buffer);
+	if (m_ysfNetwork != nullptr) {
+		while (m_ysfNetwork->read(buffer) > 0U) {
+			if (m_linkType == LINK_TYPE::YSF) {
+				// Only pass through YSF data packets
+				if (::memcmp(buffer + 0U, "YSFD", 4U) == 0 && !m_wiresX->isBusy())
+					m_rptNetwork->write(buffer);
 
-					m_lostTimer.start();
-				}
+				m_lostTimer.start();
 			}
 		}
+	}
 
-		unsigned int ms = stopWatch.elapsed();
-		stopWatch.start();
+	if (m_fcsNetwork != nullptr) {
+		while (m_fcsNetwork->read(buffer) > 0U) {
+			if (m_linkType == LINK_TYPE::FCS) {
+				// Only pass through YSF data packets
+				if (::memcmp(buffer + 0U, "YSFD", 4U) == 0 && !m_wiresX->isBusy())
+					m_rptNetwork->write(buffer);
 
-		rptNetwork.clock(ms);
-		if (m_ysfNetwork != nullptr)
-			m_ysfNetwork->clock(ms);
-		if (m_fcsNetwork != nullptr)
-			m_fcsNetwork->clock(ms);
-		if (m_writer != nullptr)
-			m_writer->clock(ms);
-		m_wiresX->clock(ms);
-
-		m_inactivityTimer.clock(ms);
-		if (m_inactivityTimer.isRunning() && m_inactivityTimer.hasExpired()) {
-			if (revert) {
-				if ((m_linkType != LINK_TYPE::NONE) && (m_current != m_startup)) {
-					LogMessage("Reverting to startup ref due to inactivity");
-					writeJSONUnlinked("timer");
-					disconnectCurrentReflector();
-					startupLinking("timer");
-				} else if ((m_linkType == LINK_TYPE::NONE) && reconnect) {
-					// reconnect if current one is timeout and reconnect = 1
-					LogMessage("Reconnecting startup reflector ...");
-					startupLinking("timer");
-				}
-			} else {
-				if ((m_linkType != LINK_TYPE::NONE) && !reconnect) {
-					LogMessage("Disconnecting due to inactivity");
-					writeJSONUnlinked("timer");
-					disconnectCurrentReflector();
-				} else if ((m_linkType == LINK_TYPE::NONE) && reconnect) {
-					LogMessage("Reconnecting reflector ...");
-					reconnectReflector("timer", m_current);
-				}
+				m_lostTimer.start();
 			}
-
-			m_inactivityTimer.start();
 		}
+	}
 
-		m_lostTimer.clock(ms);
-		if (m_lostTimer.isRunning() && m_lostTimer.hasExpired()) {
-			if (m_linkType == LINK_TYPE::YSF) {
-				LogWarning("Link has failed, polls lost");
-				m_wiresX->processDisconnect();
-				m_ysfNetwork->clearDestination();
+	m_inactivityTimer.clock(ms);
+	if (m_inactivityTimer.isRunning() && m_inactivityTimer.hasExpired()) {
+		if (m_revert) {
+			if ((m_linkType != LINK_TYPE::NONE) && (m_current != m_startup)) {
+				LogMessage("Reverting to startup ref due to inactivity");
+				writeJSONUnlinked("timer");
+				disconnectCurrentReflector();
+				startupLinking("timer");
+			} else if ((m_linkType == LINK_TYPE::NONE) && m_reconnect) {
+				// reconnect if current one is timeout and reconnect = 1
+				LogMessage("Reconnecting startup reflector ...");
+				startupLinking("timer");
 			}
-
-			if (m_fcsNetwork != nullptr) {
-				LogWarning("Link has failed, polls lost");
-				m_fcsNetwork->clearDestination();
+		} else {
+			if ((m_linkType != LINK_TYPE::NONE) && !m_reconnect) {
+				LogMessage("Disconnecting due to inactivity");
+				writeJSONUnlinked("timer");
+				disconnectCurrentReflector();
+			} else if ((m_linkType == LINK_TYPE::NONE) && m_reconnect) {
+				LogMessage("Reconnecting reflector ...");
+				reconnectReflector("timer", m_current);
 			}
-
-			m_inactivityTimer.start();
-			m_lostTimer.stop();
-			m_linkType = LINK_TYPE::NONE;
 		}
 
-		if (ms < 5U)
-			CThread::sleep(5U);
+		m_inactivityTimer.start();
 	}
 
-	LogInfo("YSFGateway is stopping");
-	writeJSONStatus("YSFGateway is stopping");
+	m_lostTimer.clock(ms);
+	if (m_lostTimer.isRunning() && m_lostTimer.hasExpired()) {
+		if (m_linkType == LINK_TYPE::YSF) {
+			LogWarning("Link has failed, polls lost");
+			m_wiresX->processDisconnect();
+			m_ysfNetwork->clearDestination();
+		}
+
+		if (m_fcsNetwork != nullptr) {
+			LogWarning("Link has failed, polls lost");
+			m_fcsNetwork->clearDestination();
+		}
+
+		m_inactivityTimer.start();
+		m_lostTimer.stop();
+		m_linkType = LINK_TYPE::NONE;
+	}
+}
 
-	rptNetwork.clearDestination();
+void CYSFGateway::close()
+{
+	m_rptNetwork->clearDestination();
 
 	if (m_gps != nullptr) {
 		m_writer->close();
@@ -467,7 +535,14 @@ int CYSFGateway::run()
 
 	delete m_wiresX;
 
-	return 0;
+	m_reflectors->stop();
+	delete m_reflectors;
+
+	m_resolver->stop();
+	delete m_resolver;
+
+	delete m_rptNetwork;
+	m_rptNetwork = nullptr;
 }
 
 void CYSFGateway::createGPS()
@@ -551,15 +626,15 @@ void CYSFGateway::createWiresX(CYSFNetwork* rptNetwork)
 	m_wiresX->start();
 }
 
-void CYSFGateway::processWiresX(const unsigned char* buffer, const CYSFFICH& fich, bool wiresXEnabledReflector, bool wiresXCommandPassthrough)
+void CYSFGateway::processWiresX(CYSFFrameView& frame, bool wiresXEnabledReflector, bool wiresXCommandPassthrough)
 {
-	assert(buffer != nullptr);
+	const unsigned char* buffer = frame.getBuffer();
 
 	WX_STATUS status;
 	if (wiresXEnabledReflector && wiresXCommandPassthrough) { // If these are BOTH true, then we ignore anything but a WiresX disconnect
-		status = m_wiresX->process(buffer + 35U, buffer + 14U, fich, true);
+		status = m_wiresX->process(frame, true);
 	} else { // Otherwise process all WiresX commands locally
-		status = m_wiresX->process(buffer + 35U, buffer + 14U, fich, false);
+		status = m_wiresX->process(frame, false);
 	}
 
 	switch (status) {
@@ -575,8 +650,8 @@ void CYSFGateway::processWiresX(const unsigned char* buffer, const CYSFFICH& fic
 				m_fcsNetwork->clearDestination();
 			}
 
-			CYSFReflector* reflector = m_wiresX->getReflector();
-			LogMessage("Connect to %5.5s - \"%s\" has been requested by %10.10s", reflector->m_id.c_str(), reflector->m_name.c_str(), buffer + 14U);
+			const CYSFReflector* reflector = m_wiresX->getReflector();
+			LogMessage("Connect to %5.5s - \"%s\" has been requested by %10.10s", reflector->m_id, reflector->m_name, buffer + 14U);
 			writeJSONLinking("user", "ysf", reflector->m_name);
 
 			m_ysfNetwork->setDestination(*reflector);
@@ -589,7 +664,7 @@ void CYSFGateway::processWiresX(const unsigned char* buffer, const CYSFFICH& fic
 
 			// If we are linking to a YSF2xxx mode, send the YSF2xxx gateway the link command too
 			if (reflector->m_wiresX && wiresXCommandPassthrough) {
-				LogMessage("Forward WiresX Connect to \"%s\"", reflector->m_name.c_str());
+				LogMessage("Forward WiresX Connect to \"%s\"", reflector->m_name);
 				m_wiresX->sendConnect(m_ysfNetwork);
 			}
 		}
@@ -611,21 +686,28 @@ void CYSFGateway::processWiresX(const unsigned char* buffer, const CYSFFICH& fic
 			m_lostTimer.stop();
 			m_linkType = LINK_TYPE::NONE;
 
-			CYSFReflector* reflector = m_wiresX->getReflector();
-			LogMessage("Connect to %s - \"%s\" has been requested by %10.10s", reflector->m_id.c_str(), reflector->m_name.c_str(), buffer + 14U);
-			writeJSONLinking("user", "fcs", reflector->m_name);
+			const CYSFReflector* reflector = m_wiresX->getReflector();
+			LogMessage("Connect to %s - \"%s\" has been requested by %10.10s", reflector->m_id, reflector->m_name, buffer + 14U);
+
+			std::string json = reflector->m_name;
 
 			std::string name = reflector->m_name;
 			name.resize(8U, '0');
 
-			bool ok = m_fcsNetwork->writeLink(name);
-			if (ok) {
-				m_current = name;
-				m_lostTimer.start();
-				m_linkType = LINK_TYPE::FCS;
-			} else {
-				LogMessage("Unknown reflector - %s", name.c_str());
-			}
+			// Until the address of the room is known the link is pending
+			m_linkType = LINK_TYPE::FCS;
+
+			m_fcsNetwork->writeLink(name, [this, name, json](bool ok) {
+				if (ok) {
+					writeJSONLinking("user", "fcs", json);
+
+					m_current = name;
+					m_lostTimer.start();
+				} else {
+					m_wiresX->processDisconnect();
+					failFCSLink(name);
+				}
+			});
 		}
 		break;
 	case WX_STATUS::DISCONNECT:
@@ -686,7 +768,7 @@ void CYSFGateway::processDTMF(unsigned char* buffer, unsigned char dt)
 	switch (status) {
 	case WX_STATUS::CONNECT_YSF: {
 			std::string id = m_dtmf.getReflector();
-			CYSFReflector* reflector = m_reflectors->findById(id);
+			const CYSFReflector* reflector = m_reflectors->findById(id);
 			if (reflector != nullptr) {
 				m_wiresX->processConnect(reflector);
 
@@ -701,7 +783,7 @@ void CYSFGateway::processDTMF(unsigned char* buffer, unsigned char dt)
 					m_fcsNetwork->clearDestination();
 				}
 
-				LogMessage("Connect via DTMF to %5.5s - \"%s\" has been requested by %10.10s", reflector->m_id.c_str(), reflector->m_name.c_str(), buffer + 14U);
+				LogMessage("Connect via DTMF to %5.5s - \"%s\" has been requested by %10.10s", reflector->m_id, reflector->m_name, buffer + 14U);
 				writeJSONLinking("user", "ysf", reflector->m_name);
 
 				m_ysfNetwork->setDestination(*reflector);
@@ -749,17 +831,20 @@ void CYSFGateway::processDTMF(unsigned char* buffer, unsigned char dt)
 
 			LogMessage("Connect via DTMF to %s has been requested by %10.10s", id.c_str(), buffer + 14U);
 
-			bool ok = m_fcsNetwork->writeLink(id);
-			if (ok) {
-				writeJSONLinking("user", "fcs", id);
+			// Until the address of the room is known the link is pending
+			m_linkType = LINK_TYPE::FCS;
 
-				m_current = id;
-				m_inactivityTimer.start();
-				m_lostTimer.start();
-				m_linkType = LINK_TYPE::FCS;
-			} else {
-				LogMessage("Unknown reflector - %s", id.c_str());
-			}
+			m_fcsNetwork->writeLink(id, [this, id](bool ok) {
+				if (ok) {
+					writeJSONLinking("user", "fcs", id);
+
+					m_current = id;
+					m_inactivityTimer.start();
+					m_lostTimer.start();
+				} else {
+					failFCSLink(id);
+				}
+			});
 		}
 		break;
 	case WX_STATUS::DISCONNECT:
@@ -853,32 +938,35 @@ void CYSFGateway::startupLinking(const std::string& reason)
 			m_current.clear();
 			m_inactivityTimer.stop();
 			m_lostTimer.stop();
-			m_linkType = LINK_TYPE::NONE;
 
-			bool ok = m_fcsNetwork->writeLink(m_startup);
 			m_fcsNetwork->setOptions(m_options);
 
-			if (ok) {
-				writeJSONLinking(reason, "fcs", m_startup);
-				LogMessage("Automatic (re-)connection to %s", m_startup.c_str());
+			// Until the address of the room is known the link is pending
+			m_linkType = LINK_TYPE::FCS;
 
-				m_current = m_startup;
-				m_inactivityTimer.start();
-				m_lostTimer.start();
-				m_linkType = LINK_TYPE::FCS;
-			} else {
-				LogMessage("Unknown reflector - %s", m_startup.c_str());
-			}
+			std::string startup = m_startup;
+			m_fcsNetwork->writeLink(startup, [this, reason, startup](bool ok) {
+				if (ok) {
+					writeJSONLinking(reason, "fcs", startup);
+					LogMessage("Automatic (re-)connection to %s", startup.c_str());
+
+					m_current = startup;
+					m_inactivityTimer.start();
+					m_lostTimer.start();
+				} else {
+					failFCSLink(startup);
+				}
+			});
 		} else if (m_ysfNetwork != nullptr) {
 			m_current.clear();
 			m_inactivityTimer.stop();
 			m_lostTimer.stop();
 			m_linkType = LINK_TYPE::NONE;
 
-			CYSFReflector* reflector = m_reflectors->findByName(m_startup);
+			const CYSFReflector* reflector = m_reflectors->findByName(m_startup);
 			if (reflector != nullptr) {
 				writeJSONLinking(reason, "ysf", reflector->m_name);
-				LogMessage("Automatic (re-)connection to %5.5s - \"%s\"", reflector->m_id.c_str(), reflector->m_name.c_str());
+				LogMessage("Automatic (re-)connection to %5.5s - \"%s\"", reflector->m_id, reflector->m_name);
 
 				m_ysfNetwork->setOptions(m_options);
 
@@ -905,27 +993,33 @@ void CYSFGateway::reconnectReflector(const std::string& reason, const std::strin
 		m_inactivityTimer.stop();
 		m_lostTimer.stop();
 
-		bool ok = m_fcsNetwork->writeLink(refNameOrId);
 		m_fcsNetwork->setOptions(m_options);
 
-		if (ok) {
-			LogMessage("(re-)connection to %s", refNameOrId.c_str());
-			writeJSONLinking(reason, "fcs", refNameOrId);
+		// Until the address of the room is known the link is pending
+		m_linkType = LINK_TYPE::FCS;
 
-			m_inactivityTimer.start();
-			m_lostTimer.start();
-			m_linkType = LINK_TYPE::FCS;
-		}
+		std::string id = refNameOrId;
+		m_fcsNetwork->writeLink(id, [this, reason, id](bool ok) {
+			if (ok) {
+				LogMessage("(re-)connection to %s", id.c_str());
+				writeJSONLinking(reason, "fcs", id);
+
+				m_inactivityTimer.start();
+				m_lostTimer.start();
+			} else {
+				failFCSLink(id);
+			}
+		});
 	} else if (m_ysfNetwork != nullptr) {
 		m_inactivityTimer.stop();
 		m_lostTimer.stop();
 
-		CYSFReflector* reflector = m_reflectors->findById(refNameOrId);
+		const CYSFReflector* reflector = m_reflectors->findById(refNameOrId);
 		if (reflector == nullptr)
 			reflector = m_reflectors->findByName(refNameOrId);
 
 		if (reflector != nullptr) {
-			LogMessage("(re-)connection to %5.5s - \"%s\"", reflector->m_id.c_str(), reflector->m_name.c_str());
+			LogMessage("(re-)connection to %5.5s - \"%s\"", reflector->m_id, reflector->m_name);
 			writeJSONLinking(reason, "ysf", reflector->m_name);
 
 			m_wiresX->setReflector(reflector);
@@ -959,6 +1053,14 @@ void CYSFGateway::disconnectCurrentReflector() {
 	m_linkType = LINK_TYPE::NONE;
 }
 
+void CYSFGateway::failFCSLink(const std::string& id)
+{
+	LogMessage("Unknown reflector - %s", id.c_str());
+
+	m_lostTimer.stop();
+	m_linkType = LINK_TYPE::NONE;
+}
+
 void CYSFGateway::readFCSRoomsFile(const std::string& filename)
 {
 	FILE* fp = ::fopen(filename.c_str(), "rt");
@@ -994,7 +1096,7 @@ void CYSFGateway::writeCommand(const std::string& command)
 		// Left trim
 		id.erase(id.begin(), std::find_if(id.begin(), id.end(), [](unsigned char c) { return !std::isspace(c); }));
 
-		CYSFReflector* reflector = m_reflectors->findById(id);
+		const CYSFReflector* reflector = m_reflectors->findById(id);
 		if (reflector == nullptr)
 			reflector = m_reflectors->findByName(id);
 
@@ -1012,7 +1114,7 @@ void CYSFGateway::writeCommand(const std::string& command)
 				m_fcsNetwork->clearDestination();
 			}
 
-			LogMessage("Connect by remote command to %5.5s - \"%s\"", reflector->m_id.c_str(), reflector->m_name.c_str());
+			LogMessage("Connect by remote command to %5.5s - \"%s\"", reflector->m_id, reflector->m_name);
 			writeJSONLinking("remote", "ysf", reflector->m_name);
 
 				m_ysfNetwork->setDestination(*reflector);
@@ -1064,17 +1166,20 @@ void CYSFGateway::writeCommand(const std::string& command)
 
 		LogMessage("Connect by remote command to %s", id.c_str());
 
-		bool ok = m_fcsNetwork->writeLink(id);
-		if (ok) {
-			writeJSONLinking("remote", "fcs", id);
+		// Until the address of the room is known the link is pending
+		m_linkType = LINK_TYPE::FCS;
 
-			m_current = id;
-			m_inactivityTimer.start();
-			m_lostTimer.start();
-			m_linkType = LINK_TYPE::FCS;
-		} else {
-			LogMessage("Unknown reflector - %s", id.c_str());
-		}
+		m_fcsNetwork->writeLink(id, [this, id](bool ok) {
+			if (ok) {
+				writeJSONLinking("remote", "fcs", id);
+
+				m_current = id;
+				m_inactivityTimer.start();
+				m_lostTimer.start();
+			} else {
+				failFCSLink(id);
+			}
+		});
 	} else if (command.substr(0, 6) == "UnLink") {
 		if (m_linkType == LINK_TYPE::YSF) {
 			m_wiresX->processDisconnect();
@@ -22,8 +22,9 @@
 #include "YSFNetwork.h"
 #include "YSFReflectors.h"
 #include "FCSNetwork.h"
+#include "DNSResolver.h"
 #include "APRSWriter.h"
-#include "YSFFICH.h"
+#include "YSFFrameView.h"
 #include "WiresX.h"
 #include "Timer.h"
 #include "Conf.h"
@@ -46,17 +47,26 @@ public:
 
 	int run();
 
+	// The steps of run(), so that the relaying can be driven one pass at a
+	// time without becoming a daemon or connecting to MQTT
+	bool readConfig();
+	bool open();
+	void clock(unsigned int ms);
+	void close();
+
 private:
 	std::string     m_callsign;
 	std::string     m_suffix;
 	CConf           m_conf;
 	CAPRSWriter*    m_writer;
 	CGPS*           m_gps;
+	CDNSResolver*   m_resolver;
 	CYSFReflectors* m_reflectors;
 	CWiresX*        m_wiresX;
 	CDTMF           m_dtmf;
 	CYSFNetwork*    m_ysfNetwork;
 	CFCSNetwork*    m_fcsNetwork;
+	CYSFNetwork*    m_rptNetwork;
 	LINK_TYPE       m_linkType;
 	std::string     m_current;
 	std::string     m_startup;
@@ -65,12 +75,16 @@ private:
 	CTimer          m_inactivityTimer;
 	CTimer          m_lostTimer;
 	bool            m_fcsNetworkEnabled;
+	bool            m_revert;
+	bool            m_reconnect;
+	bool            m_wiresXCommandPassthrough;
 
 	void startupLinking(const std::string& reason);
 	void reconnectReflector(const std::string& reason, const std::string& nameOrId);
 	void disconnectCurrentReflector();
+	void failFCSLink(const std::string& id);
 	std::string calculateLocator();
-	void processWiresX(const unsigned char* buffer, const CYSFFICH& fich, bool wiresXEnabledReflector, bool wiresXCommandPassthrough);
+	void processWiresX(CYSFFrameView& frame, bool wiresXEnabledReflector, bool wiresXCommandPassthrough);
 	void processDTMF(unsigned char* buffer, unsigned char dt);
 	void createWiresX(CYSFNetwork* rptNetwork);
 	void createGPS();
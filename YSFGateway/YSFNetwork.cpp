@@ -27,18 +27,25 @@
 
 const unsigned int BUFFER_LENGTH = 200U;
 
+const unsigned int DEFAULT_RECEIVE_BUDGET = 20U;
+
 CYSFNetwork::CYSFNetwork(const std::string& address, unsigned short port, const std::string& callsign, bool debug) :
 m_socket(address, port),
 m_debug(debug),
-m_reflector(),
+m_name(),
+m_addr(),
+m_addrLen(0U),
 m_poll(nullptr),
 m_options(nullptr),
 m_opt(),
 m_unlink(nullptr),
-m_buffer(1000U, "YSF Network Buffer"),
+m_buffer(5000U, "YSF Network Buffer"),
 m_pollTimer(1000U, 5U),
 m_linked(false),
-m_ipV6(false)
+m_budget(DEFAULT_RECEIVE_BUDGET),
+m_drained(0U),
+m_wakeups(0U),
+m_maxDrained(0U)
 {
 	m_poll = new unsigned char[14U];
 	::memcpy(m_poll + 0U, "YSFP", 4U);
@@ -62,15 +69,20 @@ m_ipV6(false)
 CYSFNetwork::CYSFNetwork(unsigned short port, const std::string& callsign, bool debug) :
 m_socket(port),
 m_debug(debug),
-m_reflector(),
+m_name(),
+m_addr(),
+m_addrLen(0U),
 m_poll(nullptr),
 m_options(nullptr),
 m_opt(),
 m_unlink(nullptr),
-m_buffer(1000U, "YSF Network Buffer"),
+m_buffer(5000U, "YSF Network Buffer"),
 m_pollTimer(1000U, 5U),
 m_linked(false),
-m_ipV6(false)
+m_budget(DEFAULT_RECEIVE_BUDGET),
+m_drained(0U),
+m_wakeups(0U),
+m_maxDrained(0U)
 {
 	m_poll = new unsigned char[14U];
 	::memcpy(m_poll + 0U, "YSFP", 4U);
@@ -98,43 +110,43 @@ CYSFNetwork::~CYSFNetwork()
 	delete[] m_options;
 }
 
-bool CYSFNetwork::open()
+bool CYSFNetwork::open(const CYSFAddress& IPv4, const CYSFAddress& IPv6)
 {
-	if (m_reflector.isEmpty()) {
+	if (!IPv4.isSet() && !IPv6.isSet()) {
 		LogError("Unable to resolve the address of the YSF network");
+		m_addrLen = 0U;
 		return false;
 	}
 
 	LogMessage("Opening YSF network connection");
 
 	bool ret = false;
-	if (m_reflector.hasIPv6()) {
-		ret = m_socket.open(m_reflector.IPv6.m_addr);
-		m_ipV6 = true;
+	if (IPv6.isSet()) {
+		IPv6.get(m_addr, m_addrLen);
+		ret = m_socket.open(m_addr);
 	}
-	if (!ret && m_reflector.hasIPv4()) {
-		ret = m_socket.open(m_reflector.IPv4.m_addr);
-		m_ipV6 = false;
+	if (!ret && IPv4.isSet()) {
+		IPv4.get(m_addr, m_addrLen);
+		ret = m_socket.open(m_addr);
 	}
 
+	if (!ret)
+		m_addrLen = 0U;
+
 	return ret;
 }
 
 bool CYSFNetwork::setDestination(const std::string& name, const sockaddr_storage& addr, unsigned int addrLen)
 {
-	m_reflector.m_id   = "99999";
-	m_reflector.m_name = name;
+	m_name = name;
 
+	CYSFAddress IPv4, IPv6;
 	switch (addr.ss_family) {
 	case AF_INET:
-		m_reflector.IPv4.m_addr    = addr;
-		m_reflector.IPv4.m_addrLen = addrLen;
-		m_reflector.IPv6.m_addrLen = 0U;
+		IPv4.set(addr, addrLen);
 		break;
 	case AF_INET6:
-		m_reflector.IPv6.m_addr    = addr;
-		m_reflector.IPv6.m_addrLen = addrLen;
-		m_reflector.IPv4.m_addrLen = 0U;
+		IPv6.set(addr, addrLen);
 		break;
 	default:
 		throw;
@@ -144,7 +156,7 @@ bool CYSFNetwork::setDestination(const std::string& name, const sockaddr_storage
 
 	close();
 
-	bool ret = open();
+	bool ret = open(IPv4, IPv6);
 	if (ret) {
 		m_pollTimer.start();
 		return true;
@@ -156,12 +168,12 @@ bool CYSFNetwork::setDestination(const std::string& name, const sockaddr_storage
 
 bool CYSFNetwork::setDestination(const CYSFReflector& reflector)
 {
-	m_reflector = reflector;
-	m_linked    = false;
+	m_name   = reflector.m_name;
+	m_linked = false;
 
 	close();
 
-	bool ret = open();
+	bool ret = open(reflector.IPv4, reflector.IPv6);
 	if (ret) {
 		m_pollTimer.start();
 		return true;
@@ -172,8 +184,9 @@ bool CYSFNetwork::setDestination(const CYSFReflector& reflector)
 
 void CYSFNetwork::clearDestination()
 {
-	m_reflector.reset();
-	m_linked = false;
+	m_name.clear();
+	m_addrLen = 0U;
+	m_linked  = false;
 
 	m_pollTimer.stop();
 
@@ -184,21 +197,18 @@ void CYSFNetwork::write(const unsigned char* data)
 {
 	assert(data != nullptr);
 
-	if (m_reflector.isEmpty())
+	if (m_addrLen == 0U)
 		return;
 
 	if (m_debug)
 		CUtils::dump(1U, "YSF Network Data Sent", data, 155U);
 
-	if (m_ipV6)
-		m_socket.write(data, 155U, m_reflector.IPv6.m_addr, m_reflector.IPv6.m_addrLen);
-	else
-		m_socket.write(data, 155U, m_reflector.IPv4.m_addr, m_reflector.IPv4.m_addrLen);
+	m_socket.write(data, 155U, m_addr, m_addrLen);
 }
 
 void CYSFNetwork::writePoll(unsigned int count)
 {
-	if (m_reflector.isEmpty())
+	if (m_addrLen == 0U)
 		return;
 
 	m_pollTimer.start();
@@ -206,19 +216,19 @@ void CYSFNetwork::writePoll(unsigned int count)
 	if (m_debug)
 		CUtils::dump(1U, "YSF Network Data Sent", m_poll, 14U);
 
-	for (unsigned int i = 0U; i < count; i++) {
-		if (m_ipV6)
-			m_socket.write(m_poll, 14U, m_reflector.IPv6.m_addr, m_reflector.IPv6.m_addrLen);
-		else
-			m_socket.write(m_poll, 14U, m_reflector.IPv4.m_addr, m_reflector.IPv4.m_addrLen);
-	}
+	// Send the polls and any options in one go, leaving room for the options
+	if (count > (UDP_BATCH_SIZE - 1U))
+		count = UDP_BATCH_SIZE - 1U;
 
-	if (!m_opt.empty()) {
-		if (m_ipV6)
-			m_socket.write(m_options, 50U, m_reflector.IPv6.m_addr, m_reflector.IPv6.m_addrLen);
-		else
-			m_socket.write(m_options, 50U, m_reflector.IPv4.m_addr, m_reflector.IPv4.m_addrLen);
-	}
+	UDPDatagram datagrams[UDP_BATCH_SIZE];
+	for (unsigned int i = 0U; i < count; i++)
+		setDatagram(datagrams[i], m_poll, 14U);
+
+	if (!m_opt.empty())
+		setDatagram(datagrams[count++], m_options, 50U);
+
+	if (count > 0U)
+		m_socket.write(datagrams, count);
 }
 
 void CYSFNetwork::setOptions(const std::string& options)
@@ -240,45 +250,97 @@ void CYSFNetwork::writeUnlink(unsigned int count)
 {
 	m_pollTimer.stop();
 
-	if (m_reflector.isEmpty())
+	if (m_addrLen == 0U)
 		return;
 
 	if (m_debug)
 		CUtils::dump(1U, "YSF Network Data Sent", m_unlink, 14U);
 
-	for (unsigned int i = 0U; i < count; i++) {
-		if (m_ipV6)
-			m_socket.write(m_unlink, 14U, m_reflector.IPv6.m_addr, m_reflector.IPv6.m_addrLen);
-		else
-			m_socket.write(m_unlink, 14U, m_reflector.IPv4.m_addr, m_reflector.IPv4.m_addrLen);
+	if (count > UDP_BATCH_SIZE)
+		count = UDP_BATCH_SIZE;
+
+	if (count > 0U) {
+		UDPDatagram datagrams[UDP_BATCH_SIZE];
+		for (unsigned int i = 0U; i < count; i++)
+			setDatagram(datagrams[i], m_unlink, 14U);
+
+		m_socket.write(datagrams, count);
 	}
 
 	m_linked = false;
 }
 
+void CYSFNetwork::setReceiveBudget(unsigned int budget)
+{
+	assert(budget > 0U);
+
+	m_budget = budget;
+}
+
 void CYSFNetwork::clock(unsigned int ms)
 {
 	m_pollTimer.clock(ms);
 	if (m_pollTimer.isRunning() && m_pollTimer.hasExpired())
 		writePoll();
 
-	unsigned char buffer[BUFFER_LENGTH];
-	sockaddr_storage addr;
-	unsigned int addrLen;
-	int length = m_socket.read(buffer, BUFFER_LENGTH, addr, addrLen);
-	if (length <= 0)
-		return;
+	unsigned char buffers[UDP_BATCH_SIZE][BUFFER_LENGTH];
+	UDPDatagram datagrams[UDP_BATCH_SIZE];
+
+	// Empty the socket each pass, up to the budget, so that a burst isn't left queued in the kernel
+	unsigned int count = 0U;
+	while (count < m_budget) {
+		// Only take as many as the ring buffer can hold
+		unsigned int wanted = (m_buffer.freeSpace() - 1U) / (BUFFER_LENGTH + 1U);
+		if (wanted > (m_budget - count))
+			wanted = m_budget - count;
+		if (wanted > UDP_BATCH_SIZE)
+			wanted = UDP_BATCH_SIZE;
+		if (wanted == 0U)
+			break;
+
+		for (unsigned int i = 0U; i < wanted; i++) {
+			datagrams[i].m_buffer = buffers[i];
+			datagrams[i].m_length = BUFFER_LENGTH;
+		}
+
+		int n = m_socket.read(datagrams, wanted);
+		if (n <= 0)
+			break;
+
+		for (int i = 0; i < n; i++)
+			receive(datagrams[i].m_buffer, datagrams[i].m_length, datagrams[i].m_addr);
+
+		count += n;
 
-	if (m_reflector.isEmpty())
+		// A short batch means the socket is now empty
+		if ((unsigned int)n < wanted)
+			break;
+	}
+
+	if (count == 0U)
 		return;
 
-	if (m_ipV6) {
-		if (!CUDPSocket::match(addr, m_reflector.IPv6.m_addr))
-			return;
-	} else {
-		if (!CUDPSocket::match(addr, m_reflector.IPv4.m_addr))
-			return;
+	// Kept for the report when the connection is closed
+	m_drained += count;
+	m_wakeups++;
+
+	if (count > m_maxDrained) {
+		m_maxDrained = count;
+
+		if (m_debug)
+			LogDebug("YSF Network drained %u packets in one pass, budget %u", count, m_budget);
 	}
+}
+
+void CYSFNetwork::receive(const unsigned char* buffer, unsigned int length, const sockaddr_storage& addr)
+{
+	assert(buffer != nullptr);
+
+	if (m_addrLen == 0U)
+		return;
+
+	if (!CUDPSocket::match(addr, m_addr))
+		return;
 
 	if (m_debug)
 		CUtils::dump(1U, "YSF Network Data Received", buffer, length);
@@ -292,19 +354,15 @@ void CYSFNetwork::clock(unsigned int ms)
 		return;
 
 	if (::memcmp(buffer, "YSFP", 4U) == 0 && !m_linked) {
-		if (m_reflector.m_name == "MMDVM")
-			LogMessage("Link successful to %s", m_reflector.m_name.c_str());
+		if (m_name == "MMDVM")
+			LogMessage("Link successful to %s", m_name.c_str());
 		else
-			LogMessage("Linked to %s", m_reflector.m_name.c_str());
+			LogMessage("Linked to %s", m_name.c_str());
 
 		m_linked = true;
 
-		if (!m_opt.empty()) {
-			if (m_ipV6)
-				m_socket.write(m_options, 50U, m_reflector.IPv6.m_addr, m_reflector.IPv6.m_addrLen);
-			else
-				m_socket.write(m_options, 50U, m_reflector.IPv4.m_addr, m_reflector.IPv4.m_addrLen);
-		}
+		if (!m_opt.empty())
+			m_socket.write(m_options, 50U, m_addr, m_addrLen);
 	}
 
 	unsigned char len = length;
@@ -328,9 +386,30 @@ unsigned int CYSFNetwork::read(unsigned char* data)
 	return len;
 }
 
+void CYSFNetwork::setDatagram(UDPDatagram& datagram, unsigned char* data, unsigned int length) const
+{
+	datagram.m_buffer = data;
+	datagram.m_length = length;
+
+	datagram.m_addr    = m_addr;
+	datagram.m_addrLen = m_addrLen;
+}
+
+const CUDPSocket& CYSFNetwork::getSocket() const
+{
+	return m_socket;
+}
+
 void CYSFNetwork::close()
 {
 	m_socket.close();
 
+	if (m_wakeups > 0U)
+		LogMessage("YSF Network received %u packets in %u passes, at most %u in one pass", m_drained, m_wakeups, m_maxDrained);
+
+	m_drained    = 0U;
+	m_wakeups    = 0U;
+	m_maxDrained = 0U;
+
 	LogMessage("Closing YSF network connection");
 }
@@ -44,14 +44,20 @@ public:
 	void setOptions(const std::string& options = "");
 	void writeUnlink(unsigned int count = 1U);
 
+	void setReceiveBudget(unsigned int budget);
+
 	unsigned int read(unsigned char* data);
 
 	void clock(unsigned int ms);
 
+	const CUDPSocket& getSocket() const;
+
 private:
 	CUDPSocket                 m_socket;
 	bool                       m_debug;
-	CYSFReflector              m_reflector;
+	std::string                m_name;
+	sockaddr_storage           m_addr;
+	unsigned int               m_addrLen;
 	unsigned char*             m_poll;
 	unsigned char*             m_options;
 	std::string                m_opt;
@@ -59,10 +65,16 @@ private:
 	CRingBuffer<unsigned char> m_buffer;
 	CTimer                     m_pollTimer;
 	bool                       m_linked;
-	bool                       m_ipV6;
+	unsigned int               m_budget;
+	unsigned int               m_drained;
+	unsigned int               m_wakeups;
+	unsigned int               m_maxDrained;
 
-	bool open();
+	bool open(const CYSFAddress& IPv4, const CYSFAddress& IPv6);
 	void close();
+
+	void receive(const unsigned char* buffer, unsigned int length, const sockaddr_storage& addr);
+	void setDatagram(UDPDatagram& datagram, unsigned char* data, unsigned int length) const;
 };
 
 #endif
@@ -22,6 +22,7 @@
 #include <fstream>
 #include <nlohmann/json.hpp>
 
+#include <unordered_set>
 #include <algorithm>
 #include <functional>
 #include <cstdio>
@@ -29,8 +30,158 @@
 #include <cstring>
 #include <cctype>
 
-CYSFReflectors::CYSFReflectors(const std::string& hostsFile, unsigned int reloadTime) :
+// ::toupper() is only defined for the values of an unsigned char
+static char toUpper(char ch)
+{
+	return char(::toupper((unsigned char)ch));
+}
+
+CYSFReflectorList::CYSFReflectorList(std::vector<CYSFReflector>&& reflectors) :
+m_reflectors(std::move(reflectors)),
+m_ids(),
+m_names(),
+m_text(m_reflectors.size() * YSF_REFLECTOR_NAME_LENGTH, ' '),
+m_lengths(m_reflectors.size(), 0U),
+m_trigrams()
+{
+	m_ids.reserve(m_reflectors.size());
+	m_names.reserve(m_reflectors.size());
+
+	// The first entry in sorted order wins, as with the old linear search
+	for (unsigned int n = 0U; n < m_reflectors.size(); n++) {
+		m_ids.emplace(m_reflectors.at(n).m_id, n);
+		m_names.emplace(normalise(m_reflectors.at(n).m_name), n);
+	}
+
+	for (unsigned int n = 0U; n < m_reflectors.size(); n++) {
+		std::string name = m_reflectors.at(n).m_name;
+		name.erase(std::find_if(name.rbegin(), name.rend(), [](unsigned char ch) { return !std::isspace(ch); }).base(), name.end());
+
+		char* text = m_text.data() + n * YSF_REFLECTOR_NAME_LENGTH;
+		::memcpy(text, name.c_str(), name.size());
+		m_lengths.at(n) = (unsigned char)name.size();
+
+		for (unsigned int i = 0U; (i + 3U) <= name.size(); i++) {
+			std::vector<unsigned int>& entries = m_trigrams[trigram(text + i)];
+			if (entries.empty() || entries.back() != n)
+				entries.push_back(n);
+		}
+	}
+}
+
+unsigned int CYSFReflectorList::size() const
+{
+	return (unsigned int)m_reflectors.size();
+}
+
+const CYSFReflector* CYSFReflectorList::at(unsigned int n) const
+{
+	return &m_reflectors.at(n);
+}
+
+const CYSFReflector* CYSFReflectorList::findById(const std::string& id) const
+{
+	auto it = m_ids.find(id);
+	if (it == m_ids.end())
+		return nullptr;
+
+	return &m_reflectors.at(it->second);
+}
+
+const CYSFReflector* CYSFReflectorList::findByName(const std::string& name) const
+{
+	// Trailing spaces aside, a name longer than the name field can match nothing
+	size_t length = name.find_last_not_of(' ') + 1U;
+	if (length > YSF_REFLECTOR_NAME_LENGTH)
+		return nullptr;
+
+	auto it = m_names.find(normalise(name));
+	if (it == m_names.end())
+		return nullptr;
+
+	return &m_reflectors.at(it->second);
+}
+
+void CYSFReflectorList::search(const std::string& name, std::vector<const CYSFReflector*>& results) const
+{
+	results.clear();
+
+	// Trailing spaces aside, a search longer than the name field can match nothing
+	unsigned int length = 0U;
+	for (unsigned int i = 0U; i < name.size(); i++) {
+		if (!std::isspace((unsigned char)name.at(i)))
+			length = i + 1U;
+	}
+
+	if (length > YSF_REFLECTOR_NAME_LENGTH)
+		return;
+
+	char text[YSF_REFLECTOR_NAME_LENGTH];
+	for (unsigned int i = 0U; i < length; i++)
+		text[i] = toUpper(name.at(i));
+
+	// The list is already in name order, so the results need no sorting
+	if (length < 3U) {
+		for (unsigned int n = 0U; n < m_reflectors.size(); n++) {
+			if (contains(n, text, length))
+				results.push_back(&m_reflectors.at(n));
+		}
+
+		return;
+	}
+
+	// Only the entries holding the rarest trigram of the search can match
+	const std::vector<unsigned int>* candidates = nullptr;
+	for (unsigned int i = 0U; (i + 3U) <= length; i++) {
+		auto it = m_trigrams.find(trigram(text + i));
+		if (it == m_trigrams.end())
+			return;
+
+		if (candidates == nullptr || it->second.size() < candidates->size())
+			candidates = &it->second;
+	}
+
+	for (const auto& n : *candidates) {
+		if (contains(n, text, length))
+			results.push_back(&m_reflectors.at(n));
+	}
+}
+
+bool CYSFReflectorList::contains(unsigned int n, const char* text, unsigned int length) const
+{
+	const char* name = m_text.data() + n * YSF_REFLECTOR_NAME_LENGTH;
+	unsigned int nameLength = m_lengths.at(n);
+
+	// An empty search matches any entry with a name
+	if (length == 0U)
+		return nameLength > 0U;
+
+	for (unsigned int i = 0U; (i + length) <= nameLength; i++) {
+		if (::memcmp(name + i, text, length) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+unsigned int CYSFReflectorList::trigram(const char* text)
+{
+	return ((unsigned char)text[0U] << 16) | ((unsigned char)text[1U] << 8) | (unsigned char)text[2U];
+}
+
+std::string CYSFReflectorList::normalise(const std::string& name)
+{
+	std::string fullName = name;
+	std::transform(fullName.begin(), fullName.end(), fullName.begin(), toUpper);
+	fullName.resize(YSF_REFLECTOR_NAME_LENGTH, ' ');
+
+	return fullName;
+}
+
+CYSFReflectors::CYSFReflectors(const std::string& hostsFile, unsigned int reloadTime, CDNSResolver& resolver) :
+CThread(),
 m_hostsFile(hostsFile),
+m_resolver(resolver),
 m_parrotAddress(),
 m_parrotPort(0U),
 m_YSF2DMRAddress(),
@@ -41,9 +192,14 @@ m_YSF2P25Address(),
 m_YSF2P25Port(0U),
 m_fcsRooms(),
 m_newReflectors(),
-m_currReflectors(),
+m_currReflectors(std::make_shared<CYSFReflectorList>(std::vector<CYSFReflector>())),
 m_search(),
-m_timer(1000U, reloadTime * 60U) 
+m_timer(1000U, reloadTime * 60U),
+m_mutex(),
+m_wakeup(),
+m_loaded(),
+m_reload(false),
+m_stopped(false)
 {
 	if (reloadTime > 0U)
 		m_timer.start();
@@ -51,26 +207,12 @@ m_timer(1000U, reloadTime * 60U)
 
 CYSFReflectors::~CYSFReflectors()
 {
-	for (const auto& it : m_newReflectors)
-		delete it;
-
-	for (const auto& it : m_currReflectors)
-		delete it;
-
-	m_newReflectors.clear();
-	m_currReflectors.clear();
 }
 
-static bool refComparison(const CYSFReflector* r1, const CYSFReflector* r2)
+static bool refComparison(const CYSFReflector& r1, const CYSFReflector& r2)
 {
-	assert(r1 != nullptr);
-	assert(r2 != nullptr);
-
-	std::string name1 = r1->m_name;
-	std::string name2 = r2->m_name;
-
-	for (unsigned int i = 0U; i < 16U; i++) {
-		int c = ::toupper(name1.at(i)) - ::toupper(name2.at(i));
+	for (unsigned int i = 0U; i < YSF_REFLECTOR_NAME_LENGTH; i++) {
+		int c = ::toupper((unsigned char)r1.m_name[i]) - ::toupper((unsigned char)r2.m_name[i]);
 		if (c != 0)
 			return c < 0;
 	}
@@ -109,10 +251,18 @@ void CYSFReflectors::addFCSRoom(const std::string& id, const std::string& name)
 
 bool CYSFReflectors::load()
 {
-	for (const auto& it : m_newReflectors)
-		delete it;
+	CYSFReflectorList* reflectors = build();
+	if (reflectors == nullptr)
+		return false;
+
+	m_newReflectors.reset(reflectors);
 
-	m_newReflectors.clear();
+	return reflectors->size() > 0U;
+}
+
+CYSFReflectorList* CYSFReflectors::build()
+{
+	std::vector<CYSFReflector> reflectors;
 
 	try {
 		std::fstream file(m_hostsFile);
@@ -125,6 +275,9 @@ bool CYSFReflectors::load()
 
 		nlohmann::json::array_t hosts = data["reflectors"];
 		for (const auto& it : hosts) {
+			if (isStopped())
+				break;
+
 			std::string id = it["designator"];
 
 			std::string country = it["country"];
@@ -154,7 +307,7 @@ bool CYSFReflectors::load()
 			bool isNull = it["ipv4"].is_null();
 			if (!isNull) {
 				std::string ipv4 = it["ipv4"];
-				if (!CUDPSocket::lookup(ipv4, port, addr_v4, addrLen_v4) == 0) {
+				if (!m_resolver.resolve(ipv4, port, addr_v4, addrLen_v4)) {
 					LogWarning("Unable to resolve the address of %s", ipv4.c_str());
 					addrLen_v4 = 0U;
 				}
@@ -166,329 +319,151 @@ bool CYSFReflectors::load()
 			isNull = it["ipv6"].is_null();
 			if (!isNull) {
 				std::string ipv6 = it["ipv6"];
-				if (!CUDPSocket::lookup(ipv6, port, addr_v6, addrLen_v6) == 0) {
+				if (!m_resolver.resolve(ipv6, port, addr_v6, addrLen_v6)) {
 					LogWarning("Unable to resolve the address of %s", ipv6.c_str());
 					addrLen_v6 = 0U;
 				}
 			}
 
 			if ((addrLen_v4 > 0U) || (addrLen_v6 > 0U)) {
-				CYSFReflector* refl = new CYSFReflector;
-				refl->m_id           = id;
-				refl->m_name         = fullName;
-				refl->m_desc         = desc;
-				refl->m_count        = count;
-				refl->m_type         = YSF_TYPE::YSF;
-				refl->m_wiresX       = (name.compare(0, 3, "XLX") == 0);
-
-				refl->m_name.resize(16U, ' ');
-				refl->m_desc.resize(14U, ' ');
-
-				refl->IPv4.m_addr    = addr_v4;
-				refl->IPv4.m_addrLen = addrLen_v4;
-				refl->IPv6.m_addr    = addr_v6;
-				refl->IPv6.m_addrLen = addrLen_v6;
-				m_newReflectors.push_back(refl);
+				CYSFReflector refl;
+				refl.setId(id);
+				refl.setName(fullName);
+				refl.setDesc(desc);
+				refl.setCount(count);
+				refl.m_type   = YSF_TYPE::YSF;
+				refl.m_wiresX = (name.compare(0, 3, "XLX") == 0);
+				refl.IPv4.set(addr_v4, addrLen_v4);
+				refl.IPv6.set(addr_v6, addrLen_v6);
+				reflectors.push_back(refl);
 			}
 		}
 	}
 	catch (...) {
 		LogError("Unable to load/parse JSON file %s", m_hostsFile.c_str());
-		return false;
+		return nullptr;
 	}
 
-	size_t size = m_newReflectors.size();
+	size_t size = reflectors.size();
 	LogInfo("Loaded %u YSF reflectors", size);
 
 	// Add the Parrot entry
-	if (m_parrotPort > 0U) {
-		sockaddr_storage addr;
-		unsigned int addrLen;
-		if (CUDPSocket::lookup(m_parrotAddress, m_parrotPort, addr, addrLen) == 0) {
-			CYSFReflector* refl = new CYSFReflector;
-			refl->m_id      = "00001";
-			refl->m_name    = "ZZ Parrot       ";
-			refl->m_desc    = "Parrot        ";
-			switch (addr.ss_family) {
-			case AF_INET:
-				refl->IPv4.m_addr    = addr;
-				refl->IPv4.m_addrLen = addrLen;
-				refl->IPv6.m_addrLen = 0U;
-				break;
-			case AF_INET6:
-				refl->IPv6.m_addr    = addr;
-				refl->IPv6.m_addrLen = addrLen;
-				refl->IPv4.m_addrLen = 0U;
-				break;
-			default:
-				refl->IPv6.m_addrLen = 0U;
-				refl->IPv4.m_addrLen = 0U;
-				LogWarning("Unknown address family for %s", m_parrotAddress.c_str());
-				break;
-			}
-			refl->m_count   = "000";
-			refl->m_type    = YSF_TYPE::YSF;
-			refl->m_wiresX  = false;
-
-			m_newReflectors.push_back(refl);
-
-			LogInfo("Loaded YSF parrot");
-		} else {
-			LogWarning("Unable to resolve the address of the YSF Parrot");
-		}
-	}
+	if (m_parrotPort > 0U)
+		addGateway(reflectors, "00001", "ZZ Parrot       ", "Parrot        ", m_parrotAddress, m_parrotPort, false, "YSF Parrot");
 
 	// Add the YSF2DMR entry
-	if (m_YSF2DMRPort > 0U) {
-		sockaddr_storage addr;
-		unsigned int addrLen;
-		if (CUDPSocket::lookup(m_YSF2DMRAddress, m_YSF2DMRPort, addr, addrLen) == 0) {
-			CYSFReflector* refl = new CYSFReflector;
-			refl->m_id      = "00002";
-			refl->m_name    = "YSF2DMR         ";
-			refl->m_desc    = "Link YSF2DMR  ";
-			switch (addr.ss_family) {
-			case AF_INET:
-				refl->IPv4.m_addr = addr;
-				refl->IPv4.m_addrLen = addrLen;
-				refl->IPv6.m_addrLen = 0U;
-				break;
-			case AF_INET6:
-				refl->IPv6.m_addr = addr;
-				refl->IPv6.m_addrLen = addrLen;
-				refl->IPv4.m_addrLen = 0U;
-				break;
-			default:
-				refl->IPv6.m_addrLen = 0U;
-				refl->IPv4.m_addrLen = 0U;
-				LogWarning("Unknown address family for %s", m_parrotAddress.c_str());
-				break;
-			}
-			refl->m_count   = "000";
-			refl->m_type    = YSF_TYPE::YSF;
-			refl->m_wiresX  = true;
-
-			m_newReflectors.push_back(refl);
-
-			LogInfo("Loaded YSF2DMR");
-		} else {
-			LogWarning("Unable to resolve the address of YSF2DMR");
-		}
-	}
+	if (m_YSF2DMRPort > 0U)
+		addGateway(reflectors, "00002", "YSF2DMR         ", "Link YSF2DMR  ", m_YSF2DMRAddress, m_YSF2DMRPort, true, "YSF2DMR");
 
 	// Add the YSF2NXDN entry
-	if (m_YSF2NXDNPort > 0U) {
-		sockaddr_storage addr;
-		unsigned int addrLen;
-		if (CUDPSocket::lookup(m_YSF2NXDNAddress, m_YSF2NXDNPort, addr, addrLen) == 0) {
-			CYSFReflector* refl = new CYSFReflector;
-			refl->m_id      = "00003";
-			refl->m_name    = "YSF2NXDN        ";
-			refl->m_desc    = "Link YSF2NXDN ";
-			switch (addr.ss_family) {
-			case AF_INET:
-				refl->IPv4.m_addr = addr;
-				refl->IPv4.m_addrLen = addrLen;
-				refl->IPv6.m_addrLen = 0U;
-				break;
-			case AF_INET6:
-				refl->IPv6.m_addr = addr;
-				refl->IPv6.m_addrLen = addrLen;
-				refl->IPv4.m_addrLen = 0U;
-				break;
-			default:
-				refl->IPv6.m_addrLen = 0U;
-				refl->IPv4.m_addrLen = 0U;
-				LogWarning("Unknown address family for %s", m_parrotAddress.c_str());
-				break;
-			}
-			refl->m_count   = "000";
-			refl->m_type    = YSF_TYPE::YSF;
-			refl->m_wiresX  = true;
-
-			m_newReflectors.push_back(refl);
-
-			LogInfo("Loaded YSF2NXDN");
-		} else {
-			LogWarning("Unable to resolve the address of YSF2NXDN");
-		}
-	}
+	if (m_YSF2NXDNPort > 0U)
+		addGateway(reflectors, "00003", "YSF2NXDN        ", "Link YSF2NXDN ", m_YSF2NXDNAddress, m_YSF2NXDNPort, true, "YSF2NXDN");
 
 	// Add the YSF2P25 entry
-	if (m_YSF2P25Port > 0U) {
-		sockaddr_storage addr;
-		unsigned int addrLen;
-		if (CUDPSocket::lookup(m_YSF2P25Address, m_YSF2P25Port, addr, addrLen) == 0) {
-			CYSFReflector* refl = new CYSFReflector;
-			refl->m_id      = "00004";
-			refl->m_name    = "YSF2P25         ";
-			refl->m_desc    = "Link YSF2P25  ";
-			switch (addr.ss_family) {
-			case AF_INET:
-				refl->IPv4.m_addr = addr;
-				refl->IPv4.m_addrLen = addrLen;
-				refl->IPv6.m_addrLen = 0U;
-				break;
-			case AF_INET6:
-				refl->IPv6.m_addr = addr;
-				refl->IPv6.m_addrLen = addrLen;
-				refl->IPv4.m_addrLen = 0U;
-				break;
-			default:
-				refl->IPv6.m_addrLen = 0U;
-				refl->IPv4.m_addrLen = 0U;
-				LogWarning("Unknown address family for %s", m_parrotAddress.c_str());
-				break;
-			}
-			refl->m_count   = "000";
-			refl->m_type    = YSF_TYPE::YSF;
-			refl->m_wiresX  = true;
+	if (m_YSF2P25Port > 0U)
+		addGateway(reflectors, "00004", "YSF2P25         ", "Link YSF2P25  ", m_YSF2P25Address, m_YSF2P25Port, true, "YSF2P25");
 
-			m_newReflectors.push_back(refl);
-
-			LogInfo("Loaded YSF2P25");
-		} else {
-			LogWarning("Unable to resolve the address of YSF2P25");
-		}
-	}
+	std::unordered_set<std::string> used;
+	for (const auto& it : reflectors)
+		used.insert(it.m_id);
 
 	unsigned int id = 9U;
 	for (const auto& it1 : m_fcsRooms) {
-		bool used;
+		char text[10U];
 		do {
 			id++;
-			used = findById(id);
-		} while (used);
-
-		char text[10U];
-		::sprintf(text, "%05u", id);
-
-		std::string name = it1.first;
-		std::string desc = it1.second;
-
-		CYSFReflector* refl = new CYSFReflector;
-		refl->m_id           = text;
-		refl->m_name         = name;
-		refl->m_desc         = desc;
-		refl->IPv4.m_addrLen = 0U;
-		refl->IPv6.m_addrLen = 0U;
-		refl->m_count        = "000";
-		refl->m_type         = YSF_TYPE::FCS;
-		refl->m_wiresX       = false;
-
-		refl->m_name.resize(16U, ' ');
-		refl->m_desc.resize(14U, ' ');
-
-		m_newReflectors.push_back(refl);
+			::sprintf(text, "%05u", id);
+		} while (used.count(text) > 0U);
+
+		CYSFReflector refl;
+		refl.setId(text);
+		refl.setName(it1.first);
+		refl.setDesc(it1.second);
+		refl.m_type   = YSF_TYPE::FCS;
+		refl.m_wiresX = false;
+		reflectors.push_back(refl);
 	}
 
-	size = m_newReflectors.size();
-	if (size == 0U)
-		return false;
-
-	for (auto& it : m_newReflectors) {
-		std::transform(it->m_name.begin(), it->m_name.end(), it->m_name.begin(), ::toupper);
-		std::transform(it->m_desc.begin(), it->m_desc.end(), it->m_desc.begin(), ::toupper);
+	for (auto& it : reflectors) {
+		std::transform(it.m_name, it.m_name + YSF_REFLECTOR_NAME_LENGTH, it.m_name, toUpper);
+		std::transform(it.m_desc, it.m_desc + YSF_REFLECTOR_DESC_LENGTH, it.m_desc, toUpper);
 	}
 
-	std::sort(m_newReflectors.begin(), m_newReflectors.end(), refComparison);
+	std::sort(reflectors.begin(), reflectors.end(), refComparison);
 
-	return true;
+	return new CYSFReflectorList(std::move(reflectors));
 }
 
-CYSFReflector* CYSFReflectors::findById(const std::string& id)
+void CYSFReflectors::addGateway(std::vector<CYSFReflector>& reflectors, const std::string& id, const std::string& name, const std::string& desc, const std::string& address, unsigned short port, bool wiresX, const std::string& label)
 {
-	for (const auto& it : m_currReflectors) {
-		if (id == it->m_id)
-			return it;
+	sockaddr_storage addr;
+	unsigned int addrLen;
+	if (!m_resolver.resolve(address, port, addr, addrLen)) {
+		LogWarning("Unable to resolve the address of %s", label.c_str());
+		return;
+	}
+
+	CYSFReflector refl;
+	refl.setId(id);
+	refl.setName(name);
+	refl.setDesc(desc);
+	switch (addr.ss_family) {
+	case AF_INET:
+		refl.IPv4.set(addr, addrLen);
+		break;
+	case AF_INET6:
+		refl.IPv6.set(addr, addrLen);
+		break;
+	default:
+		LogWarning("Unknown address family for %s", address.c_str());
+		break;
 	}
+	refl.m_type   = YSF_TYPE::YSF;
+	refl.m_wiresX = wiresX;
 
-	LogMessage("Trying to find non existent YSF reflector with an id of %s", id.c_str());
+	reflectors.push_back(refl);
 
-	return nullptr;
+	LogInfo("Loaded %s", label.c_str());
 }
 
-bool CYSFReflectors::findById(unsigned int id) const
+const CYSFReflector* CYSFReflectors::findById(const std::string& id)
 {
-	char text[10U];
-	::sprintf(text, "%05u", id);
+	const CYSFReflector* refl = m_currReflectors->findById(id);
+	if (refl == nullptr)
+		LogMessage("Trying to find non existent YSF reflector with an id of %s", id.c_str());
 
-	for (const auto& it : m_newReflectors) {
-		if (text == it->m_id)
-			return true;
-	}
-
-	return false;
+	return refl;
 }
 
-CYSFReflector* CYSFReflectors::findByName(const std::string& name)
+const CYSFReflector* CYSFReflectors::findByName(const std::string& name)
 {
-	std::string fullName = name;
-	std::transform(fullName.begin(), fullName.end(), fullName.begin(), ::toupper);
-	fullName.resize(16U, ' ');
-
-	for (std::vector<CYSFReflector*>::const_iterator it = m_currReflectors.cbegin(); it != m_currReflectors.cend(); ++it) {
-		if (fullName == (*it)->m_name)
-			return *it;
-	}
+	const CYSFReflector* refl = m_currReflectors->findByName(name);
+	if (refl == nullptr)
+		LogMessage("Trying to find non existent YSF reflector with a name of %s", name.c_str());
 
-	LogMessage("Trying to find non existent YSF reflector with a name of %s", name.c_str());
-
-	return nullptr;
+	return refl;
 }
 
-std::vector<CYSFReflector*>& CYSFReflectors::current()
+std::shared_ptr<const CYSFReflectorList> CYSFReflectors::current() const
 {
 	return m_currReflectors;
 }
 
-std::vector<CYSFReflector*>& CYSFReflectors::search(const std::string& name)
+std::vector<const CYSFReflector*>& CYSFReflectors::search(const std::string& name)
 {
-	m_search.clear();
-
-	std::string trimmed = name;
-	trimmed.erase(std::find_if(trimmed.rbegin(), trimmed.rend(), [](unsigned char ch) { return !std::isspace(ch); }).base(), trimmed.end());
-	std::transform(trimmed.begin(), trimmed.end(), trimmed.begin(), ::toupper);
-
-	// Removed now un-used variable
-	// size_t len = trimmed.size();
-
-	for (const auto& it : m_currReflectors) {
-		std::string reflector = it->m_name;
-		reflector.erase(std::find_if(reflector.rbegin(), reflector.rend(), [](unsigned char ch) { return !std::isspace(ch); }).base(),reflector.end());
-		std::transform(reflector.begin(), reflector.end(), reflector.begin(), ::toupper);
-
-		// Original match function - only matches start of string.
-		// if (trimmed == reflector.substr(0U, len))
-		// 	m_search.push_back(*it);
-
-		// New match function searches the whole string
-		for (unsigned int refSrcPos = 0U; refSrcPos < reflector.length(); refSrcPos++) {
-			if (reflector.substr(refSrcPos, trimmed.length()) == trimmed) {
-				m_search.push_back(it);
-				break;
-			}
-		}
-	}
-
-	std::sort(m_search.begin(), m_search.end(), refComparison);
+	m_currReflectors->search(name, m_search);
 
 	return m_search;
 }
 
 bool CYSFReflectors::reload()
 {
-	if (m_newReflectors.empty())
+	if (m_newReflectors == nullptr)
 		return false;
 
-	for (const auto& it : m_currReflectors)
-		delete it;
-
-	m_currReflectors.clear();
-
 	m_currReflectors = m_newReflectors;
 
-	m_newReflectors.clear();
+	m_newReflectors.reset();
 
 	return true;
 }
@@ -498,7 +473,63 @@ void CYSFReflectors::clock(unsigned int ms)
 	m_timer.clock(ms);
 
 	if (m_timer.isRunning() && m_timer.hasExpired()) {
-		load();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_reload = true;
+		}
+
+		m_wakeup.notify_one();
+
 		m_timer.start();
 	}
+
+	std::shared_ptr<const CYSFReflectorList> loaded;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		loaded.swap(m_loaded);
+	}
+
+	if (loaded != nullptr)
+		m_newReflectors = loaded;
+}
+
+void CYSFReflectors::entry()
+{
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeup.wait(lock, [this] { return m_stopped || m_reload; });
+			if (m_stopped)
+				return;
+
+			m_reload = false;
+		}
+
+		std::shared_ptr<const CYSFReflectorList> reflectors(build());
+		if (reflectors == nullptr)
+			continue;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_loaded = reflectors;
+	}
+}
+
+void CYSFReflectors::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopped = true;
+	}
+
+	m_wakeup.notify_one();
+
+	wait();
+}
+
+bool CYSFReflectors::isStopped()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_stopped;
 }
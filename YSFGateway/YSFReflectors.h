@@ -19,11 +19,18 @@
 #if !defined(YSFReflectors_H)
 #define	YSFReflectors_H
 
+#include "DNSResolver.h"
 #include "UDPSocket.h"
+#include "Thread.h"
 #include "Timer.h"
 
+#include <condition_variable>
+#include <unordered_map>
+#include <algorithm>
+#include <memory>
 #include <vector>
 #include <string>
+#include <mutex>
 
 #include <cstring>
 
@@ -32,102 +39,150 @@ enum class YSF_TYPE {
 	FCS
 };
 
+const unsigned int YSF_REFLECTOR_ID_LENGTH    = 5U;
+const unsigned int YSF_REFLECTOR_NAME_LENGTH  = 16U;
+const unsigned int YSF_REFLECTOR_DESC_LENGTH  = 14U;
+const unsigned int YSF_REFLECTOR_COUNT_LENGTH = 3U;
+
+// Holds an IPv4 or IPv6 address in the space of a sockaddr_in6 rather than
+// a full sockaddr_storage, it is copied out when a link is made.
+class CYSFAddress {
+public:
+	CYSFAddress() :
+	m_addrLen(0U)
+	{
+		::memset(m_addr, 0x00, sizeof(m_addr));
+	}
+
+	void set(const sockaddr_storage& addr, unsigned int addrLen)
+	{
+		if (addrLen > sizeof(m_addr))
+			addrLen = 0U;
+
+		::memcpy(m_addr, &addr, addrLen);
+		m_addrLen = addrLen;
+	}
+
+	void get(sockaddr_storage& addr, unsigned int& addrLen) const
+	{
+		::memset(&addr, 0x00, sizeof(sockaddr_storage));
+		::memcpy(&addr, m_addr, m_addrLen);
+		addrLen = m_addrLen;
+	}
+
+	bool isSet() const
+	{
+		return m_addrLen > 0U;
+	}
+
+private:
+	unsigned char m_addr[sizeof(sockaddr_in6)];
+	unsigned char m_addrLen;
+};
+
+// The text fields are held space padded to their Wires-X widths, and NUL
+// terminated so that they can be logged directly. The whole entry is plain
+// data so that a list of them is a single contiguous block.
 class CYSFReflector {
 public:
 	CYSFReflector() :
-	m_id(),
-	m_name(),
-	m_desc(),
-	m_count("000"),
 	m_type(YSF_TYPE::YSF),
-	m_wiresX(false)
+	m_wiresX(false),
+	IPv4(),
+	IPv6()
 	{
-		IPv4.m_addrLen = 0U;
-		IPv6.m_addrLen = 0U;
+		setId("");
+		setName("");
+		setDesc("");
+		setCount("000");
 	}
 
-	CYSFReflector(const CYSFReflector& in)
+	void setId(const std::string& id)
 	{
-		m_id     = in.m_id;
-		m_name   = in.m_name;
-		m_desc   = in.m_desc;
-		m_count  = in.m_count;
-		m_type   = in.m_type;
-		m_wiresX = in.m_wiresX;
-
-		IPv4.m_addrLen = in.IPv4.m_addrLen;
-		IPv6.m_addrLen = in.IPv6.m_addrLen;
-
-		::memcpy(&IPv4.m_addr, &in.IPv4.m_addr, sizeof(sockaddr_storage));
-		::memcpy(&IPv6.m_addr, &in.IPv6.m_addr, sizeof(sockaddr_storage));
+		copy(m_id, id, YSF_REFLECTOR_ID_LENGTH);
 	}
 
-	bool isEmpty() const
+	void setName(const std::string& name)
 	{
-		return m_id.empty();
+		copy(m_name, name, YSF_REFLECTOR_NAME_LENGTH);
 	}
 
-	bool isUsed() const
+	void setDesc(const std::string& desc)
 	{
-		return !m_id.empty();
+		copy(m_desc, desc, YSF_REFLECTOR_DESC_LENGTH);
 	}
 
-	void reset()
+	void setCount(const std::string& count)
 	{
-		m_id.clear();
-		m_name.clear();
+		copy(m_count, count, YSF_REFLECTOR_COUNT_LENGTH);
 	}
 
 	bool hasIPv4() const
 	{
-		return IPv4.m_addrLen > 0U;
+		return IPv4.isSet();
 	}
 
 	bool hasIPv6() const
 	{
-		return IPv6.m_addrLen > 0U;
+		return IPv6.isSet();
 	}
 
-	std::string m_id;
-	std::string m_name;
-	std::string m_desc;
-	std::string m_count;
+	char        m_id[YSF_REFLECTOR_ID_LENGTH + 1U];
+	char        m_name[YSF_REFLECTOR_NAME_LENGTH + 1U];
+	char        m_desc[YSF_REFLECTOR_DESC_LENGTH + 1U];
+	char        m_count[YSF_REFLECTOR_COUNT_LENGTH + 1U];
 	YSF_TYPE    m_type;
 	bool        m_wiresX;
-	struct {
-		sockaddr_storage m_addr;
-		unsigned int     m_addrLen;
-	} IPv4;
-	struct {
-		sockaddr_storage m_addr;
-		unsigned int     m_addrLen;
-	} IPv6;
-
-	CYSFReflector& operator=(const CYSFReflector& in)
+	CYSFAddress IPv4;
+	CYSFAddress IPv6;
+
+private:
+	static void copy(char* out, const std::string& in, unsigned int length)
 	{
-		if (&in != this) {
-			m_id     = in.m_id;
-			m_name   = in.m_name;
-			m_desc   = in.m_desc;
-			m_count  = in.m_count;
-			m_type   = in.m_type;
-			m_wiresX = in.m_wiresX;
-
-			IPv4.m_addrLen = in.IPv4.m_addrLen;
-			IPv6.m_addrLen = in.IPv6.m_addrLen;
-
-			::memcpy(&IPv4.m_addr, &in.IPv4.m_addr, sizeof(sockaddr_storage));
-			::memcpy(&IPv6.m_addr, &in.IPv6.m_addr, sizeof(sockaddr_storage));
-		}
-
-		return *this;
+		::memset(out, ' ', length);
+		::memcpy(out, in.c_str(), std::min<size_t>(in.size(), length));
+		out[length] = 0x00;
 	}
 };
 
-class CYSFReflectors {
+// An immutable list of reflectors, a new one is built on every reload of the
+// hosts file. Anyone still holding the previous list keeps it alive, so a
+// reflector that is in use never disappears underneath its user.
+class CYSFReflectorList {
 public:
-	CYSFReflectors(const std::string& hostsFile, unsigned int reloadTime);
-	~CYSFReflectors();
+	CYSFReflectorList(std::vector<CYSFReflector>&& reflectors);
+
+	unsigned int size() const;
+
+	const CYSFReflector* at(unsigned int n) const;
+
+	const CYSFReflector* findById(const std::string& id) const;
+
+	// Names are matched without regard to case. Trailing spaces aside, a name
+	// or a search longer than the 16 character name field matches nothing.
+	const CYSFReflector* findByName(const std::string& name) const;
+
+	void search(const std::string& name, std::vector<const CYSFReflector*>& results) const;
+
+private:
+	std::vector<CYSFReflector>                            m_reflectors;
+	std::unordered_map<std::string, unsigned int>         m_ids;
+	std::unordered_map<std::string, unsigned int>         m_names;
+	// The trimmed names in fixed 16 byte slots, and which entries hold each trigram
+	std::vector<char>                                     m_text;
+	std::vector<unsigned char>                            m_lengths;
+	std::unordered_map<unsigned int, std::vector<unsigned int>> m_trigrams;
+
+	bool contains(unsigned int n, const char* text, unsigned int length) const;
+
+	static std::string normalise(const std::string& name);
+	static unsigned int trigram(const char* text);
+};
+
+class CYSFReflectors : public CThread {
+public:
+	CYSFReflectors(const std::string& hostsFile, unsigned int reloadTime, CDNSResolver& resolver);
+	virtual ~CYSFReflectors();
 
 	void setParrot(const std::string& address, unsigned short port);
 	void setYSF2DMR(const std::string& address, unsigned short port);
@@ -137,19 +192,24 @@ public:
 
 	bool load();
 
-	CYSFReflector* findById(const std::string& id);
-	CYSFReflector* findByName(const std::string& name);
+	const CYSFReflector* findById(const std::string& id);
+	const CYSFReflector* findByName(const std::string& name);
 
-	std::vector<CYSFReflector*>& current();
+	std::shared_ptr<const CYSFReflectorList> current() const;
 
-	std::vector<CYSFReflector*>& search(const std::string& name);
+	std::vector<const CYSFReflector*>& search(const std::string& name);
 
 	bool reload();
 
 	void clock(unsigned int ms); 
 
+	virtual void entry();
+
+	void stop();
+
 private:
 	std::string                 m_hostsFile;
+	CDNSResolver&               m_resolver;
 	std::string                 m_parrotAddress;
 	unsigned short              m_parrotPort;
 	std::string                 m_YSF2DMRAddress;
@@ -159,12 +219,21 @@ private:
 	std::string                 m_YSF2P25Address;
 	unsigned short              m_YSF2P25Port;
 	std::vector<std::pair<std::string, std::string>> m_fcsRooms;
-	std::vector<CYSFReflector*> m_newReflectors;
-	std::vector<CYSFReflector*> m_currReflectors;
-	std::vector<CYSFReflector*> m_search;
+	std::shared_ptr<const CYSFReflectorList> m_newReflectors;
+	std::shared_ptr<const CYSFReflectorList> m_currReflectors;
+	std::vector<const CYSFReflector*>        m_search;
 	CTimer                      m_timer;
+	std::mutex                  m_mutex;
+	std::condition_variable     m_wakeup;
+	std::shared_ptr<const CYSFReflectorList> m_loaded;
+	bool                        m_reload;
+	bool                        m_stopped;
+
+	CYSFReflectorList* build();
+
+	void addGateway(std::vector<CYSFReflector>& reflectors, const std::string& id, const std::string& name, const std::string& desc, const std::string& address, unsigned short port, bool wiresX, const std::string& label);
 
-	bool findById(unsigned int id) const;
+	bool isStopped();
 };
 
 #endif
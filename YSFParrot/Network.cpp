@@ -22,12 +22,14 @@
 #include <cassert>
 #include <cstring>
 
-const unsigned int BUFFER_LENGTH = 200U;
-
 CNetwork::CNetwork(unsigned short port) :
 m_socket(port),
 m_addr(),
-m_addrLen(0U)
+m_addrLen(0U),
+m_buffers(),
+m_datagrams(),
+m_count(0U),
+m_next(0U)
 {
 }
 
@@ -77,11 +79,30 @@ bool CNetwork::writePoll(const sockaddr_storage& addr, unsigned int addrLen)
 
 unsigned int CNetwork::read(unsigned char* data)
 {
-	sockaddr_storage addr;
-	unsigned int addrLen;
-	int length = m_socket.read(data, BUFFER_LENGTH, addr, addrLen);
-	if (length <= 0)
-		return 0U;
+	assert(data != nullptr);
+
+	// Refill from the socket with one batched read once the last batch has been used up
+	if (m_next >= m_count) {
+		for (unsigned int i = 0U; i < UDP_BATCH_SIZE; i++) {
+			m_datagrams[i].m_buffer = m_buffers[i];
+			m_datagrams[i].m_length = NETWORK_BUFFER_LENGTH;
+		}
+
+		int n = m_socket.read(m_datagrams, UDP_BATCH_SIZE);
+
+		m_count = (n > 0) ? (unsigned int)n : 0U;
+		m_next  = 0U;
+
+		if (m_count == 0U)
+			return 0U;
+	}
+
+	const UDPDatagram& datagram = m_datagrams[m_next++];
+
+	::memcpy(data, datagram.m_buffer, datagram.m_length);
+
+	const sockaddr_storage& addr = datagram.m_addr;
+	unsigned int addrLen         = datagram.m_addrLen;
 
 	// Handle incoming polls
 	if (::memcmp(data, "YSFP", 4U) == 0) {
@@ -24,6 +24,8 @@
 #include <cstdint>
 #include <string>
 
+const unsigned int NETWORK_BUFFER_LENGTH = 200U;
+
 class CNetwork {
 public:
 	CNetwork(unsigned short port);
@@ -43,6 +45,10 @@ private:
 	CUDPSocket       m_socket;
 	sockaddr_storage m_addr;
 	unsigned int     m_addrLen;
+	unsigned char    m_buffers[UDP_BATCH_SIZE][NETWORK_BUFFER_LENGTH];
+	UDPDatagram      m_datagrams[UDP_BATCH_SIZE];
+	unsigned int     m_count;
+	unsigned int     m_next;
 
 	bool writePoll(const sockaddr_storage& addr, unsigned int addrLen);
 };
@@ -336,6 +336,132 @@ bool CUDPSocket::write(const unsigned char* buffer, unsigned int length, const s
 	return result;
 }
 
+int CUDPSocket::read(UDPDatagram* datagrams, unsigned int count)
+{
+	assert(datagrams != nullptr);
+	assert(count > 0U && count <= UDP_BATCH_SIZE);
+
+#if defined(_WIN32) || defined(_WIN64)
+	if (m_fd == INVALID_SOCKET)
+		return 0;
+
+	// No recvmmsg() on Windows, so read them one at a time
+	unsigned int n = 0U;
+	while (n < count) {
+		int len = read(datagrams[n].m_buffer, datagrams[n].m_length, datagrams[n].m_addr, datagrams[n].m_addrLen);
+		if (len < 0)
+			return (n > 0U) ? int(n) : -1;
+		if (len == 0)
+			break;
+
+		datagrams[n].m_length = len;
+		n++;
+	}
+
+	return int(n);
+#else
+	if (m_fd == -1)
+		return 0;
+
+	struct mmsghdr msgs[UDP_BATCH_SIZE];
+	struct iovec   iovs[UDP_BATCH_SIZE];
+
+	::memset(msgs, 0x00U, count * sizeof(struct mmsghdr));
+
+	for (unsigned int i = 0U; i < count; i++) {
+		iovs[i].iov_base = datagrams[i].m_buffer;
+		iovs[i].iov_len  = datagrams[i].m_length;
+
+		msgs[i].msg_hdr.msg_name    = &datagrams[i].m_addr;
+		msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+		msgs[i].msg_hdr.msg_iov     = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen  = 1U;
+	}
+
+	// Return immediately with whatever is already queued
+	int ret = ::recvmmsg(m_fd, msgs, count, MSG_DONTWAIT, nullptr);
+	if (ret < 0) {
+		if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+			return 0;
+
+		LogError("Error returned from recvmmsg on UDP socket on port %u, err: %d", m_localPort, errno);
+
+		if (errno == ENOTSOCK) {
+			LogMessage("Re-opening UDP port");
+			close();
+			open();
+		}
+
+		return -1;
+	}
+
+	for (int i = 0; i < ret; i++) {
+		datagrams[i].m_length  = msgs[i].msg_len;
+		datagrams[i].m_addrLen = msgs[i].msg_hdr.msg_namelen;
+	}
+
+	return ret;
+#endif
+}
+
+unsigned int CUDPSocket::write(const UDPDatagram* datagrams, unsigned int count)
+{
+	assert(datagrams != nullptr);
+#if defined(_WIN32) || defined(_WIN64)
+	assert(m_fd != INVALID_SOCKET);
+
+	// No sendmmsg() on Windows, so send them one at a time
+	unsigned int n = 0U;
+	for (unsigned int i = 0U; i < count; i++) {
+		if (write(datagrams[i].m_buffer, datagrams[i].m_length, datagrams[i].m_addr, datagrams[i].m_addrLen))
+			n++;
+	}
+
+	return n;
+#else
+	assert(m_fd >= 0);
+
+	struct mmsghdr msgs[UDP_BATCH_SIZE];
+	struct iovec   iovs[UDP_BATCH_SIZE];
+
+	unsigned int next = 0U;
+	unsigned int sent = 0U;
+	while (next < count) {
+		unsigned int n = count - next;
+		if (n > UDP_BATCH_SIZE)
+			n = UDP_BATCH_SIZE;
+
+		::memset(msgs, 0x00U, n * sizeof(struct mmsghdr));
+
+		for (unsigned int i = 0U; i < n; i++) {
+			const UDPDatagram& datagram = datagrams[next + i];
+
+			iovs[i].iov_base = datagram.m_buffer;
+			iovs[i].iov_len  = datagram.m_length;
+
+			msgs[i].msg_hdr.msg_name    = (void*)&datagram.m_addr;
+			msgs[i].msg_hdr.msg_namelen = datagram.m_addrLen;
+			msgs[i].msg_hdr.msg_iov     = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen  = 1U;
+		}
+
+		// This stops at the first datagram that cannot be sent, which is
+		// skipped so that one bad destination does not hold up the others
+		int ret = ::sendmmsg(m_fd, msgs, n, 0);
+		if (ret <= 0) {
+			LogError("Error returned from sendmmsg on UDP socket on port %u, err: %d", m_localPort, errno);
+			next++;
+			continue;
+		}
+
+		next += (unsigned int)ret;
+		sent += (unsigned int)ret;
+	}
+
+	return sent;
+#endif
+}
+
 void CUDPSocket::close()
 {
 #if defined(_WIN32) || defined(_WIN64)
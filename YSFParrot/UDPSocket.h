@@ -40,6 +40,18 @@ enum class IPMATCHTYPE {
 	ADDRESS_ONLY
 };
 
+// The most datagrams handed to the kernel in one batched read or write. A
+// batched read may be asked for no more than this, a batched write sends
+// any number, this many at a time.
+const unsigned int UDP_BATCH_SIZE = 16U;
+
+struct UDPDatagram {
+	unsigned char*   m_buffer;
+	unsigned int     m_length;
+	sockaddr_storage m_addr;
+	unsigned int     m_addrLen;
+};
+
 class CUDPSocket {
 public:
 	CUDPSocket(const std::string& address, unsigned short port = 0U);
@@ -52,6 +64,9 @@ public:
 	int  read(unsigned char* buffer, unsigned int length, sockaddr_storage& address, unsigned int &addressLength);
 	bool write(const unsigned char* buffer, unsigned int length, const sockaddr_storage& address, unsigned int addressLength);
 
+	int          read(UDPDatagram* datagrams, unsigned int count);
+	unsigned int write(const UDPDatagram* datagrams, unsigned int count);
+
 	void close();
 
 	static void startup();